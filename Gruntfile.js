@@ -25,6 +25,16 @@ module.exports = function (grunt) {
     dist: 'dist'
   };
 
+  // Scripts and views loaded on demand by some states, see LazyLoader.
+  // Each bundle is built into its own scripts/<name>.js.
+  var bundles = require('./' + appConfig.app + '/scripts/bundles.json');
+
+  function bundleViews() {
+    return Object.keys(bundles).reduce(function (views, name) {
+      return views.concat(bundles[name].views);
+    }, []);
+  }
+
   // Define the configuration for all the tasks
   grunt.initConfig({
 
@@ -46,7 +56,7 @@ module.exports = function (grunt) {
       },
       jsTest: {
         files: ['test/spec/{,*/}*.js'],
-        tasks: ['newer:jshint:test', 'newer:jscs:test', 'karma']
+        tasks: ['newer:jshint:test', 'newer:jscs:test', 'karma:unit']
       },
       styles: {
         files: ['<%= yeoman.app %>/styles/{,*/}*.css'],
@@ -235,6 +245,8 @@ module.exports = function (grunt) {
       dist: {
         src: [
           '<%= yeoman.dist %>/scripts/{,*/}*.js',
+          // Workers are loaded by name, see EventChannel and ReportService.
+          '!<%= yeoman.dist %>/scripts/workers/*.js',
           '<%= yeoman.dist %>/styles/{,*/}*.css',
           '<%= yeoman.dist %>/images/{,*/}*.{png,jpg,jpeg,gif,webp,svg}',
           '<%= yeoman.dist %>/styles/fonts/*'
@@ -351,7 +363,9 @@ module.exports = function (grunt) {
           usemin: 'scripts/scripts.js'
         },
         cwd: '<%= yeoman.app %>',
-        src: 'views/{,*/}*.html',
+        src: ['views/{,*/}*.html'].concat(bundleViews().map(function (view) {
+          return '!' + view;
+        })),
         dest: '.tmp/templateCache.js'
       }
     },
@@ -387,9 +401,9 @@ module.exports = function (grunt) {
           src: [
             '*.{ico,png,txt}',
             '*.html',
+            'scripts/workers/*.js',
             'images/{,*/}*.{webp}',
-            'styles/fonts/{,*/}*.*',
-            'scripts/filters/languages/*.js'
+            'styles/fonts/{,*/}*.*'
           ]
         }, {
           expand: true,
@@ -436,11 +450,100 @@ module.exports = function (grunt) {
       unit: {
         configFile: 'test/karma.conf.js',
         singleRun: true
+      },
+      bench: {
+        configFile: 'test/bench/karma.conf.js'
       }
     }
   });
 
 
+  // Templates, concatenation and minification of each lazy bundle, next
+  // to the targets useminPrepare generates for index.html.
+  Object.keys(bundles).forEach(function (name) {
+    grunt.config.set(['ngtemplates', name], {
+      options: {
+        module: 'armaditoApp',
+        htmlmin: '<%= htmlmin.dist.options %>'
+      },
+      cwd: '<%= yeoman.app %>',
+      src: bundles[name].views,
+      dest: '.tmp/templates/' + name + '.js'
+    });
+
+    grunt.config.set(['concat', name], {
+      src: bundles[name].scripts.map(function (script) {
+        return '<%= yeoman.app %>/' + script;
+      }).concat(['.tmp/templates/' + name + '.js']),
+      dest: '.tmp/concat/scripts/' + name + '.js'
+    });
+
+    grunt.config.set(['uglify', name], {
+      src: '.tmp/concat/scripts/' + name + '.js',
+      dest: '<%= yeoman.dist %>/scripts/' + name + '.js'
+    });
+  });
+
+  // Points the runtime manifest at the revisioned bundle files.
+  grunt.registerTask('bundles', 'Write the manifest of the built bundles', function () {
+    var summary = grunt.filerev ? grunt.filerev.summary : {};
+    var manifest = {};
+
+    Object.keys(bundles).forEach(function (name) {
+      var file = appConfig.dist + '/scripts/' + name + '.js';
+      manifest[name] = {
+        scripts: [(summary[file] || file).replace(appConfig.dist + '/', '')]
+      };
+    });
+
+    grunt.file.write(appConfig.dist + '/scripts/bundles.json', JSON.stringify(manifest));
+  });
+
+  // The language tables go into scripts.js as the TRANSLATIONS constant
+  // instead of being fetched at startup. Runs after useminPrepare, like
+  // ngtemplates with its usemin option.
+  grunt.registerTask('translations', 'Compile the language tables', function () {
+    var cwd = appConfig.app + '/scripts/filters/languages/';
+    var tables = {};
+
+    grunt.file.expand({cwd: cwd}, '*.js').forEach(function (file) {
+      tables[file.replace(/\.js$/, '')] = grunt.file.readJSON(cwd + file);
+    });
+
+    grunt.file.write('.tmp/scripts/translations.js',
+      '\'use strict\';\n' +
+      'angular.module(\'armaditoApp\').constant(\'TRANSLATIONS\', ' + JSON.stringify(tables) + ');\n');
+
+    var generated = grunt.config('concat.generated');
+    generated.files.forEach(function (file) {
+      if (/scripts\/scripts\.js$/.test(file.dest)) {
+        file.src.push('.tmp/scripts/translations.js');
+      }
+    });
+    grunt.config('concat.generated', generated);
+  });
+
+  // Versions the service worker with the content of the build and lists
+  // the files it keeps, see app/sw.js. Runs last, on the final files.
+  grunt.registerTask('shellcache', 'Write the service worker of the build', function () {
+    var crypto = require('crypto');
+    var hash = crypto.createHash('md5');
+    var files = grunt.file.expand({cwd: appConfig.dist, filter: 'isFile'}, ['**/*', '!sw.js', '!404.html', '!robots.txt']).sort();
+
+    files.forEach(function (file) {
+      hash.update(file);
+      hash.update(grunt.file.read(appConfig.dist + '/' + file, {encoding: null}));
+    });
+
+    var worker = grunt.file.read(appConfig.app + '/sw.js')
+      .replace('var VERSION = null;', 'var VERSION = ' + JSON.stringify(hash.digest('hex').substr(0, 12)) + ';')
+      // Only files of the build: cache.addAll() fails as a whole on any
+      // URL the server does not answer, and navigations use index.html.
+      .replace('var SHELL = [];', 'var SHELL = ' + JSON.stringify(files) + ';');
+
+    grunt.file.write(appConfig.dist + '/sw.js', worker);
+  });
+
   grunt.registerTask('serve', 'Compile then start a connect web server', function (target) {
     if (target === 'dist') {
       return grunt.task.run(['build', 'connect:dist:keepalive']);
@@ -467,15 +570,20 @@ module.exports = function (grunt) {
     'concurrent:test',
     'postcss',
     'connect:test',
-    'karma'
+    'karma:unit'
   ]);
 
+  // Replays scan event streams in headless Chrome and appends the results
+  // to bench_output.txt, see test/bench/README.md.
+  grunt.registerTask('bench', ['karma:bench']);
+
   grunt.registerTask('build', [
     'clean:dist',
     'wiredep',
     'useminPrepare',
     'concurrent:dist',
     'postcss',
+    'translations',
     'ngtemplates',
     'concat',
     'ngAnnotate',
@@ -484,8 +592,10 @@ module.exports = function (grunt) {
     'cssmin',
     'uglify',
     'filerev',
+    'bundles',
     'usemin',
-    'htmlmin'
+    'htmlmin',
+    'shellcache'
   ]);
 
   grunt.registerTask('default', [
@@ -33,22 +33,24 @@ var a6oApp = angular
   .module('armaditoApp', [
     'ngAnimate',
     'ngAria',
-    'ngCookies',
-    'ngMessages',
-    'ngResource',
-    'ngRoute',
     'ngSanitize',
-    'ngTouch',
     'ui.router',
     'ui.bootstrap',
-    'timer',
     'toastr',
     'pascalprecht.translate',
-    'truncate',
-    'angularMoment',
     'TreeWidget'
   ])
-  .config(function ($stateProvider, $urlRouterProvider, toastrConfig, $translateProvider) {
+  // Kept for LazyLoader, which registers the components of bundles loaded
+  // after bootstrap.
+  .config(function ($controllerProvider, $compileProvider, $filterProvider, $provide) {
+      a6oApp.providers = {
+        $controllerProvider: $controllerProvider,
+        $compileProvider: $compileProvider,
+        $filterProvider: $filterProvider,
+        $provide: $provide
+      };
+  })
+  .config(function ($stateProvider, $urlRouterProvider, toastrConfig, $translateProvider, $injector) {
 	  
       angular.extend(toastrConfig, {
 		    progressBar: false,
@@ -59,20 +61,51 @@ var a6oApp = angular
      
       $translateProvider.useSanitizeValueStrategy('escape');
 
-      $translateProvider.useStaticFilesLoader({
-        prefix: 'scripts/filters/languages/',
-        suffix: '.js'
-      });
+      // Builds compile the language tables into the TRANSLATIONS constant
+      // (see the 'translations' grunt task); from the sources they are
+      // fetched at startup.
+      if ($injector.has('TRANSLATIONS'))
+      {
+        var tables = $injector.get('TRANSLATIONS');
+        Object.keys(tables).forEach(function (language) {
+          $translateProvider.translations(language, tables[language]);
+        });
+      }
+      else
+      {
+        $translateProvider.useStaticFilesLoader({
+          prefix: 'scripts/filters/languages/',
+          suffix: '.js'
+        });
+      }
 
       $translateProvider.preferredLanguage('en_US');
 
       $urlRouterProvider.otherwise("/Main");
 
+      // The view is only requested once its bundle is loaded, so that the
+      // controller exists when ui-router instantiates it and the template
+      // comes from the bundle's cache in a build.
+      function lazyView(bundle, templateUrl)
+      {
+        return ['LazyLoader', '$templateRequest', function (LazyLoader, $templateRequest) {
+          return LazyLoader.load(bundle).then(function () {
+            return $templateRequest(templateUrl);
+          });
+        }];
+      }
+
       $stateProvider
         .state('Main', {
           url: '/Main',
           templateUrl: 'views/Main.html',
-          controller: 'MainController'
+          controller: 'MainController',
+          // Views bind their labels once, the table must be there first.
+          resolve: {
+            translations: ['$translate', function ($translate) {
+              return $translate.onReady();
+            }]
+          }
         })
         .state('Main.Information', {
           url: '/Information',
@@ -81,17 +114,45 @@ var a6oApp = angular
         })
         .state('Main.Scan', {
           url: '/Scan',
-          templateUrl: 'views/Scan.html',
+          templateProvider: lazyView('scan', 'views/Scan.html'),
           controller: 'ScanController'
         })
         .state('Main.Journal', {
           url: '/Journal',
-          templateUrl: 'views/Journal.html',
+          templateProvider: lazyView('journal', 'views/Journal.html'),
           controller: 'JournalController'
         })
         .state('Main.Parameters', {
           url: '/Parameters',
-          templateUrl: 'views/Parameters.html',
+          templateProvider: lazyView('parameters', 'views/Parameters.html'),
           controller: 'ParametersController'
         });
 });
+
+// Scans of a previous session are found again before any view needs them;
+// the update queue has to listen by then.
+a6oApp.run(function (ScanUpdateQueue, ScanService) {
+  ScanService.reattach();
+});
+
+// The shell is kept by a service worker so that later starts do not wait
+// on the daemon, see sw.js.
+a6oApp.run(function ($window) {
+  if ($window.navigator.serviceWorker) {
+    $window.navigator.serviceWorker.register('sw.js').catch(function (e) {
+      console.error("Error when registering the service worker : " + e);
+    });
+  }
+});
+
+// Labels are bound once: a language change redraws the current views once.
+a6oApp.run(function ($rootScope, $state) {
+  var language = null;
+
+  $rootScope.$on('$translateChangeSuccess', function (event, data) {
+    if (language !== null && data.language !== language) {
+      $state.reload();
+    }
+    language = data.language;
+  });
+});
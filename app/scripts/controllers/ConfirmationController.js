@@ -33,6 +33,7 @@ angular.module('armaditoApp')
 
   	$scope.sentence = data.sentence;
   	$scope.title = data.title;
+  	$scope.values = data.values;
 
 	if(global.scan_in_progress){
 	    $scope.sentence = "main_view.Scan_in_progress";
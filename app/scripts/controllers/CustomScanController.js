@@ -30,8 +30,8 @@ along with Armadito gui.  If not, see <http://www.gnu.org/licenses/>.
  */
 angular.module('armaditoApp')
   .controller('CustomScanController',
-            ['$scope', '$uibModalInstance', 'items', 'BrowseService',
-    function ($scope,   $uibModalInstance,   items,   BrowseService)
+            ['$scope', '$uibModalInstance', 'items', 'BrowseService', 'ScanProfiles',
+    function ($scope,   $uibModalInstance,   items,   BrowseService,   ScanProfiles)
     {
         $scope.items = items;
 
@@ -39,7 +39,48 @@ angular.module('armaditoApp')
             pathToScan : '',
             heuristicMode : false,
             scanArchive : false,
-            excludeFolder : ''
+            excludeFolder : '',
+            exclusions : []
+        };
+
+        $scope.profiles = ScanProfiles.profiles;
+        $scope.profile = { name : '' };
+
+        $scope.addExclusion = function ()
+        {
+            var pattern = $scope.optionScan.excludeFolder.trim();
+
+            if (pattern && $scope.optionScan.exclusions.indexOf(pattern) === -1)
+            {
+                $scope.optionScan.exclusions.push(pattern);
+            }
+            $scope.optionScan.excludeFolder = '';
+        };
+
+        $scope.removeExclusion = function (index)
+        {
+            $scope.optionScan.exclusions.splice(index, 1);
+        };
+
+        $scope.applyProfile = function (profile)
+        {
+            if (!profile)
+            {
+                return;
+            }
+
+            $scope.optionScan.heuristicMode = profile.heuristicMode;
+            $scope.optionScan.scanArchive = profile.scanArchive;
+            $scope.optionScan.exclusions = profile.exclusions.slice();
+            $scope.profile.name = profile.name;
+        };
+
+        $scope.saveProfile = function ()
+        {
+            if ($scope.profile.name)
+            {
+                ScanProfiles.saveProfile($scope.profile.name, $scope.optionScan);
+            }
         };
 
         $scope.ok = function ()
@@ -66,7 +107,6 @@ angular.module('armaditoApp')
             }, false);
         };
 
-        $scope.excludedFolders = [];
         $scope.chooseFileToExclude = function ()
         {
             var name = '#fileToExclude';
@@ -76,12 +116,8 @@ angular.module('armaditoApp')
                 var path = this.value;
                 $scope.$apply(function()
                 {
-                    $scope.pathToExclude = path;
-                    var optionScan = {
-                        pathToScan : $scope.pathToExclude
-                    };
-                    $scope.excludedFolders.push(optionScan);
-
+                    $scope.optionScan.excludeFolder = path;
+                    $scope.addExclusion();
                 })
             }, false);
         };
@@ -95,46 +131,116 @@ angular.module('armaditoApp')
 
         $scope.optionsTreeWidget = { expandOnClick: true, showIcon : true};
 
-        $scope.$on('selection-changed', function (e, node)
+        // Folders of the highlighted node whose listing is fetched ahead:
+        // each costs the daemon a directory read, so only a couple.
+        var PREFETCH_COUNT = 2;
+
+        // Parents of the "more" entries, kept out of the nodes themselves
+        // so that the tree holds no circular reference.
+        var more_parents = {};
+        var next_more_id = 1;
+
+        // Network errors and timeouts come without the daemon's answer.
+        function browseError(error, path)
         {
-            $scope.breadcrums = [];
-            var testBread = node.full_path.split("/");
-            testBread.shift();
-            $scope.breadcrums = testBread;
-            $scope.optionScan.pathToScan = node.full_path;
+            var details = error && error.data && error.data.data;
 
-            if(node.type === "folder" || node.type === "root")
+            $scope.showError = true;
+            if (details && details.path)
+            {
+                $scope.error = "Error cannot access to path : " + "<b>"+ details.path + "</b> " + " reason : " + "<b>" + details.error + "</b>";
+            }
+            else
             {
-                BrowseService.browse(node.full_path).then(
-                    function (successData)
+                $scope.error = "Error cannot access to path : " + "<b>"+ path + "</b> " + " reason : " + "<b>HTTP status " + (error && error.status) + "</b>";
+            }
+            console.error('Error : ' + $scope.error);
+        }
+
+        // Appends one page of the listing of node to its children, followed
+        // by a "more" entry when the daemon has further pages. `more` is the
+        // entry that asked for the page, put back when it fails to load.
+        function loadPage(node, offset, more)
+        {
+            node.loading = true;
+
+            BrowseService.browsePage(node.full_path, offset).then(
+                function (successData)
+                {
+                    var prefetched = 0;
+
+                    $scope.showError = false;
+                    node.loading = false;
+                    node.loaded = true;
+
+                    for (var i = 0; i < successData.content.length; i++)
                     {
-                        $scope.showError = false;
-                        node.children = [];
-                        for (var i = 0; i < successData.content.length; i++)
+                        var child = angular.extend({}, successData.content[i]);
+
+                        if((child.type === "folder") && (!child.expanded))
                         {
-                            if((successData.content[i].type === "folder") && (!successData.content[i].expanded))
-                            {
-                                successData.content[i].image = "/app/images/folder.png";
-                            }
-                            else if ((successData.content[i].type === "folder") && (successData.content[i].expanded))
-                            {
-                                successData.content[i].image = "/app/images/folder-open.png";
-                            }
-                            node.children.push(successData.content[i]);
+                            child.image = "/app/images/folder.png";
                         }
-                    },
-                    function(error)
-                    {
-                        $scope.showError = true;
-                        $scope.error = "Error cannot access to path : " + "<b>"+ error.data.data.path + "</b> " + " reason : " + "<b>" + error.data.data.error + "</b>";
-                        console.error('Error : ' + $scope.error);
+                        else if ((child.type === "folder") && (child.expanded))
+                        {
+                            child.image = "/app/images/folder-open.png";
+                        }
+                        node.children.push(child);
+
+                        if (child.type === "folder" && prefetched < PREFETCH_COUNT)
+                        {
+                            BrowseService.prefetch(child.full_path);
+                            prefetched++;
+                        }
+                    }
 
-                    },
-                    function (progress)
+                    if (successData.next_offset !== null)
                     {
-                        console.info('Progress : ' + progress);
+                        more_parents[next_more_id] = node;
+                        node.children.push({
+                            name: "...",
+                            full_path: node.full_path,
+                            type: "more",
+                            more_id: next_more_id++,
+                            next_offset: successData.next_offset
+                        });
                     }
-                );
+                },
+                function (error)
+                {
+                    node.loading = false;
+                    if (more)
+                    {
+                        more_parents[more.more_id] = node;
+                        node.children.push(more);
+                    }
+                    browseError(error, node.full_path);
+                }
+            );
+        }
+
+        $scope.$on('selection-changed', function (e, node)
+        {
+            if (node.type === "more")
+            {
+                var parent = more_parents[node.more_id];
+                delete more_parents[node.more_id];
+                parent.children.splice(parent.children.indexOf(node), 1);
+                loadPage(parent, node.next_offset, node);
+                return;
+            }
+
+            $scope.breadcrums = [];
+            var testBread = node.full_path.split("/");
+            testBread.shift();
+            $scope.breadcrums = testBread;
+            $scope.optionScan.pathToScan = node.full_path;
+
+            // A folder already listed is not fetched again.
+            if((node.type === "folder" || node.type === "root") && !node.loaded && !node.loading)
+            {
+                node.children = [];
+                loadPage(node, 0);
             }
         });
     }
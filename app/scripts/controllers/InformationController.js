@@ -29,9 +29,15 @@ along with Armadito gui.  If not, see <http://www.gnu.org/licenses/>.
  * Controller of the armaditoApp
  */
 angular.module('armaditoApp')
-  .controller('InformationController', ['$rootScope', '$scope', 'StatusService', 
-    function ($rootScope, $scope, StatusService)
+  .controller('InformationController', ['$rootScope', '$scope', 'StatusService', 'FleetService', 'UpdateService',
+    function ($rootScope, $scope, StatusService, FleetService, UpdateService)
     {
+        var STATUS_LABELS = {
+            'up-to-date': 'information_view.Status_up_to_date',
+            'critical': 'information_view.Status_critical',
+            'late': 'information_view.Status_late',
+            'unavailable': 'information_view.Status_unavailable'
+        };
 
 		$scope.timeConverter = function(timestamp)
         {
@@ -45,21 +51,94 @@ angular.module('armaditoApp')
             return datevalues;
 		};
 
+        function decorate(module)
+        {
+            module.update_date = $scope.timeConverter(module.mod_update_timestamp);
+            module.status_label = STATUS_LABELS[module.mod_status] || '';
+        }
+
+	    // Listen first, getStatus may answer right away from the known status.
+	    // A delta only changes the rows of the modules it names.
+	    $scope.$on('$destroy', $rootScope.$on('StatusEvent', function(event, status, changed)
+        {
+            $scope.databases_update = status.global_status;
+            $scope.last_update = $scope.timeConverter(status.global_update_timestamp);
+
+            var all = !changed || $scope.modules !== status.modules;
+            $scope.modules = status.modules;
+
+            for (var i = 0; i < $scope.modules.length; i++)
+            {
+                if (all || changed.indexOf($scope.modules[i].name) !== -1)
+                {
+                    decorate($scope.modules[i]);
+                }
+            }
+	    }));
+
+        // Signature update started from the refresh icon, its progress is
+        // shown on the rows of the modules being updated.
+        $scope.db_update = UpdateService.current;
+
+        $scope.$on('$destroy', $rootScope.$on('UpdateProgress', function (event, update)
+        {
+            $scope.db_update = update;
+        }));
+
+        // Rows show the update while it runs, and keep the modules it
+        // failed to update once it is over.
+        $scope.showsUpdate = function (module)
+        {
+            var step = $scope.db_update && $scope.db_update.modules[module.name];
+
+            return !!step && ($scope.db_update.running || step.state === "failed");
+        };
+
+        $scope.update_db = function ()
+        {
+            UpdateService.start();
+        };
+
+        $scope.megabytes = function (bytes)
+        {
+            return Math.round(bytes / 104857.6) / 10;
+        };
+
 	    StatusService.getStatus();
 
-	    $rootScope.$on('StatusEvent', function(event, data)
+        // Other daemons watched from this console, rolled up by module.
+        $scope.status_labels = STATUS_LABELS;
+        $scope.fleet = { url: "" };
+        $scope.fleet_hosts = FleetService.hosts;
+        $scope.show_fleet = false;
+
+        $scope.$on('$destroy', $rootScope.$on('FleetChanged', function ()
         {
-            $scope.databases_update = data.global_status;
-            $scope.last_update = $scope.timeConverter(data.global_update_timestamp);
-            $scope.modules = data.modules;
+            $scope.fleet_rollup = FleetService.rollup();
+        }));
 
-            console.log(data);
+        FleetService.start();
+        $scope.fleet_rollup = FleetService.rollup();
 
-            for (var i = 0; i< $scope.modules.length ; i++){
-					$scope.modules[i].mod_update_timestamp = $scope.timeConverter($scope.modules[i].mod_update_timestamp);
-			}
+        $scope.toggleFleet = function ()
+        {
+            $scope.show_fleet = !$scope.show_fleet;
+        };
 
-            $scope.$apply();
-	    });
+        $scope.addHost = function ()
+        {
+            if ($scope.fleet.url)
+            {
+                FleetService.addHost($scope.fleet.url);
+                $scope.fleet.url = "";
+                $scope.fleet_rollup = FleetService.rollup();
+            }
+        };
+
+        $scope.removeHost = function (host)
+        {
+            FleetService.removeHost(host);
+            $scope.fleet_rollup = FleetService.rollup();
+        };
     }
 ]);
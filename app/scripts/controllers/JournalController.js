@@ -29,163 +29,253 @@ along with Armadito gui.  If not, see <http://www.gnu.org/licenses/>.
  * Controller of the armaditoApp
  */
 angular.module('armaditoApp')
-  .controller('JournalController', ['$scope', '$uibModal','toastr', function ($scope, $uibModal, toastr) {
-
-    var Noms = ['Malware1', 'Malware2', 'Malware3', 'Malware4'];
-    var Emplacements = ['/home/userName/...', '/home/Desktop/folder/...', '/home/userName/...', '/home/userName/...'];
-    var Dates = ['05/11/2015', '18/11/2015', '13/12/2015', '15/12/2015'];
-    var id = 1;
-
-	$scope.quarantine = {
-		count : 0,
-		last_update : "1970",
-		files: []
-	};
-
-	$scope.quarantineObjects = [
-		{
-			name: 'malware',
-			path: 'C:/Users/Bla/bla/bla',
-			date: '04/12/2015',
-			refresh : '<i class="fa fa-refresh"></i>',
-			delete  : '<i class="text-danger fa fa-times"></i>'
-		},
-		{
-			name: 'malware',
-			path: 'C:/Users/Bla/bla/bla',
-			date: '04/12/2015',
-			refresh : '<i class="fa fa-refresh"></i>',
-			delete  : '<i class="text-danger fa fa-times"></i>'
-		}
-	];
-
-	$scope.refreshQuatantineObject = function (index){
-		$scope.quarantineObjects.splice(index, 1);
-
-	};
-
-	$scope.deleteQuatantineObject = function (index){
-		$scope.quarantineObjects.splice(index, 1);
-
-	};
-
-	$scope.clearQuarantine = function (){
-      	var size = 'sm';
-      	var item = {
-      		title : 'Confirmation de suppression',
-      		sentence : "Etes vous sûr de vouloir suprimer "+ $scope.quarantineObjects.length + " objets de la quarantaines ?"
-      	};
-      	var modalInstance = $uibModal.open({
-	        animation: $scope.animationsEnabled,
-	        templateUrl: 'views/Confirmation.html',
-	        controller: 'ConfirmationController',
-	        size: size,
-	        resolve: {
-	          data: function () {
-	            return  item;
-	          }
-	        }
-      	});
-
-      	modalInstance.result.then(function () {
-	        $scope.quarantineObjects = [];
-	        toastr.success('Suppression d\'objets en quarantaine effectuée avec succès.');
-	    }, function () {
-
-      	});
-	};
-
-	$scope.quarantine.files = [];
-
-	$scope.status = {};
-	$scope.status.openDay = true;
-	$scope.status.openWeek = false;
-	$scope.status.openMonth = false;
-	$scope.status.openYear = false;
-
-    function generateRandomItem(id) {
-
-        var Nom = Noms[Math.floor(Math.random() * 3)];
-        var Emplacement = Emplacements[Math.floor(Math.random() * 3)];
-        var Date = Dates[Math.floor(Math.random() * 3)];
-
-        return {
-            id: id,
-            Nom: Nom,
-            Emplacement: Emplacement,
-            Date : Date
+  .controller('JournalController', ['$scope', '$uibModal', '$translate', 'toastr', 'JournalService', 'QuarantineService',
+    function ($scope, $uibModal, $translate, toastr, JournalService, QuarantineService) {
+
+    $scope.journal_types = ['scan', 'update', 'quarantine', 'service'];
+
+    // Both tabs are daemon queries, alerts being the detection entries.
+    $scope.journal = JournalService.query({});
+    $scope.alerts = JournalService.query({type: 'detection'});
+
+    $scope.journal.reload();
+    $scope.alerts.reload();
+
+    $scope.$watch('journal.filters', function (filters, previous)
+    {
+        if (filters !== previous)
+        {
+            $scope.journal.reload();
         }
-    }
+    }, true);
+
+    $scope.$watch('alerts.filters.q', function (q, previous)
+    {
+        if (q !== previous)
+        {
+            $scope.alerts.reload();
+        }
+    });
 
-    $scope.rowCollection = [];
+    $scope.clearFilters = function ()
+    {
+        $scope.journal.filters = {};
+    };
 
-    for (id; id < 4; id++) {
-        $scope.rowCollection.push(generateRandomItem(id));
+    // Quarantined files are loaded page by page. The selection is either
+    // a set of ids or "all files matching the search", which the daemon
+    // resolves by itself.
+    $scope.quarantine = QuarantineService.query({});
+    $scope.selection = { ids: {}, all: false };
+
+    // Running bulk operations, each reported once it has ended.
+    $scope.operations = [];
+
+    function clearSelection()
+    {
+        $scope.selection = { ids: {}, all: false };
     }
 
-    //copy the references (you could clone ie angular.copy but then have to go through a dirty checking for the matches)
-    $scope.displayedCollection = [].concat($scope.rowCollection);
+    $scope.query_quarantine = function ()
+    {
+        clearSelection();
+        $scope.quarantine.reload();
+    };
+
+    $scope.$watch('quarantine.filters.q', function (q, previous)
+    {
+        if (q !== previous)
+        {
+            $scope.query_quarantine();
+        }
+    });
+
+    $scope.isSelected = function (obj)
+    {
+        return $scope.selection.all || $scope.selection.ids[obj.id] !== undefined;
+    };
+
+    $scope.selectedCount = function ()
+    {
+        if ($scope.selection.all)
+        {
+            return ($scope.quarantine.total !== null) ? $scope.quarantine.total : $scope.quarantine.entries.length;
+        }
+        return Object.keys($scope.selection.ids).length;
+    };
+
+    $scope.toggleFile = function (obj)
+    {
+        if ($scope.selection.all)
+        {
+            return;
+        }
 
-    //add to the real data holder
-    $scope.addRandomItem = function () {
-        $scope.rowCollection.push(generateRandomItem(id));
-        id++;
+        if ($scope.selection.ids[obj.id] !== undefined)
+        {
+            delete $scope.selection.ids[obj.id];
+        }
+        else
+        {
+            $scope.selection.ids[obj.id] = obj.id;
+        }
     };
 
-    //remove to the real data holder
-    $scope.removeItem = function (row) {
-        var index = $scope.rowCollection.indexOf(row);
-        $scope.rowCollection.splice(index, 1);
+    $scope.allLoadedSelected = function ()
+    {
+        return $scope.quarantine.entries.length > 0
+            && $scope.selectedCount() >= $scope.quarantine.entries.length;
     };
 
-    /*Open modal for rapport details*/
-    $scope.items = ['Date : 01/02/2015', 'Chemin fichier : blablabla', 'Type : Blablablabla'];
+    $scope.toggleLoaded = function ()
+    {
+        var select = !$scope.allLoadedSelected();
+
+        clearSelection();
+        if (select)
+        {
+            angular.forEach($scope.quarantine.entries, function (obj)
+            {
+                $scope.selection.ids[obj.id] = obj.id;
+            });
+        }
+    };
 
-      $scope.animationsEnabled = true;
+    $scope.selectAllMatching = function ()
+    {
+        $scope.selection = { ids: {}, all: true };
+    };
 
-      $scope.open = function (size) {
+    function selectionRequest()
+    {
+        if ($scope.selection.all)
+        {
+            return { filter: { q: $scope.quarantine.filters.q || "" } };
+        }
 
-        var modalInstance = $uibModal.open({
-          animation: $scope.animationsEnabled,
-          templateUrl: 'views/RapportDetails.html',
-          controller: 'RapportDetailsController',
-          size: size,
-          resolve: {
-            items: function () {
-              return $scope.items;
+        var ids = [];
+        angular.forEach($scope.selection.ids, function (id)
+        {
+            ids.push(id);
+        });
+        return { ids: ids };
+    }
+
+    function confirm(sentence, count)
+    {
+        return $uibModal.open({
+            animation: $scope.animationsEnabled,
+            templateUrl: 'views/Confirmation.html',
+            controller: 'ConfirmationController',
+            size: 'sm',
+            resolve: {
+                data: function () {
+                    return {
+                        title : 'journal_view.Quarantine_tab.Confirm_title',
+                        sentence : sentence,
+                        values : { count: count }
+                    };
+                }
             }
-          }
+        }).result;
+    }
+
+    function operationEnded(operation)
+    {
+        var values = { done: operation.done, failed: operation.failed, status: operation.error };
+        var index = $scope.operations.indexOf(operation);
+
+        if (index !== -1)
+        {
+            $scope.operations.splice(index, 1);
+        }
+
+        if (operation.error !== undefined)
+        {
+            toastr.error($translate.instant('journal_view.Quarantine_tab.Operation_error', values));
+        }
+        else if (operation.failed)
+        {
+            toastr.warning($translate.instant('journal_view.Quarantine_tab.Operation_failed', values));
+        }
+        else
+        {
+            toastr.success($translate.instant('journal_view.Quarantine_tab.Operation_done', values));
+        }
+        $scope.query_quarantine();
+    }
+
+    function runOperation(action, selection)
+    {
+        var operation = QuarantineService.apply(action, selection);
+
+        $scope.operations.push(operation);
+        clearSelection();
+        operation.promise.then(operationEnded, operationEnded);
+    }
+
+    $scope.restoreSelected = function ()
+    {
+        runOperation('restore', selectionRequest());
+    };
+
+    $scope.deleteSelected = function ()
+    {
+        var selection = selectionRequest();
+
+        confirm('journal_view.Quarantine_tab.Confirm_delete', $scope.selectedCount()).then(function ()
+        {
+            runOperation('delete', selection);
         });
+    };
+
+    $scope.restore_quarantine_file = function (obj)
+    {
+        runOperation('restore', { ids: [obj.id] });
+    };
+
+    $scope.delete_quarantine_file = function (obj)
+    {
+        runOperation('delete', { ids: [obj.id] });
+    };
 
-        modalInstance.result.then(function (selectedItem) {
-          $scope.selected = selectedItem;
-        }, function () {
+    $scope.clearQuarantine = function ()
+    {
+        var count = ($scope.quarantine.total !== null) ? $scope.quarantine.total : $scope.quarantine.entries.length;
 
+        confirm('journal_view.Quarantine_tab.Confirm_clear', count).then(function ()
+        {
+            runOperation('delete', { filter: {} });
         });
-      };
-
-      $scope.toggleAnimation = function () {
-        $scope.animationsEnabled = !$scope.animationsEnabled;
-      };
-
-       	$scope.openDetailRapport = function (size) {
-
-		    var modalInstance = $uibModal.open({
-		      animation: $scope.animationsEnabled,
-		      templateUrl: 'views/DetailRapportModal.html',
-		      controller: 'DetailRapportModalController',
-		      size: size,
-		      resolve: {
-		        items: function () {
-		          return $scope.items;
-		        }
-		      }
-		    });
-
-		    modalInstance.result.then(function (selectedItem) {
-		      $scope.selected = selectedItem;
-		    }, function () {
-
-		    });
-		  };
+    };
+
+    $scope.quarantine.reload();
+
+    $scope.status = {};
+    $scope.status.openDay = true;
+    $scope.status.openWeek = false;
+    $scope.status.openMonth = false;
+    $scope.status.openYear = false;
+
+    $scope.animationsEnabled = true;
+
+    // Entries of completed scans carry the id of their report.
+    $scope.openReport = function (entry)
+    {
+        if (!entry.report_id)
+        {
+            return;
+        }
+
+        $uibModal.open({
+            animation: $scope.animationsEnabled,
+            templateUrl: 'views/RapportDetails.html',
+            controller: 'RapportDetailsController',
+            resolve: {
+                report: function () {
+                    return entry;
+                }
+            }
+        });
+    };
   }]);
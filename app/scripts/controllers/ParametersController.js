@@ -29,8 +29,180 @@ along with Armadito gui.  If not, see <http://www.gnu.org/licenses/>.
  * Controller of the armaditoApp
  */
 angular.module('armaditoApp')
-  .controller('ParametersController',['$scope', function ($scope) {
+  .controller('ParametersController',['$scope', '$translate', 'toastr', 'ScanProfiles', 'ScanPolicy',
+  		function ($scope, $translate, toastr, ScanProfiles, ScanPolicy) {
 
+	$scope.profiles = ScanProfiles.profiles;
 
+	// previous_name is the name the edited profile is saved under.
+	$scope.newProfile = function () {
+		$scope.editedProfile = {
+			previous_name : null,
+			name : '',
+			heuristicMode : false,
+			scanArchive : false,
+			exclusions : [],
+			excludeFolder : ''
+		};
+	};
+
+	$scope.editProfile = function (profile) {
+		$scope.editedProfile = angular.extend(angular.copy(profile), { excludeFolder : '', previous_name : profile.name });
+	};
+
+	$scope.addExclusion = function () {
+		var pattern = $scope.editedProfile.excludeFolder.trim();
+
+		if (pattern && $scope.editedProfile.exclusions.indexOf(pattern) === -1) {
+			$scope.editedProfile.exclusions.push(pattern);
+		}
+		$scope.editedProfile.excludeFolder = '';
+	};
+
+	$scope.removeExclusion = function (index) {
+		$scope.editedProfile.exclusions.splice(index, 1);
+	};
+
+	$scope.saveProfile = function () {
+		var edited = $scope.editedProfile;
+
+		if (!edited.name) {
+			return;
+		}
+
+		ScanProfiles.saveProfile(edited.name, edited, edited.previous_name);
+
+		// Schedules follow a renamed profile; sent with the next applyPolicy().
+		if (edited.previous_name && edited.previous_name !== edited.name) {
+			angular.forEach($scope.policy.schedules, function (schedule) {
+				if (schedule.profile_name === edited.previous_name) {
+					schedule.profile_name = edited.name;
+				}
+			});
+		}
+		edited.previous_name = edited.name;
+	};
+
+	$scope.removeProfile = function (profile) {
+		ScanProfiles.removeProfile(profile.name);
+		if ($scope.editedProfile && $scope.editedProfile.name === profile.name) {
+			$scope.newProfile();
+		}
+	};
+
+	$scope.newProfile();
+
+	// The policy is edited on a copy, sent as a whole by applyPolicy().
+	$scope.priorities = ScanPolicy.priorities;
+	$scope.week_days = [1, 2, 3, 4, 5, 6, 0];
+	$scope.policy = angular.copy(ScanPolicy.policy);
+
+	function pad(value) {
+		return (value < 10 ? '0' : '') + value;
+	}
+
+	$scope.loadPolicy = function () {
+		ScanPolicy.load().then(function (policy) {
+			$scope.policy = angular.copy(policy);
+			$scope.newSchedule();
+		});
+	};
+
+	$scope.applyPolicy = function () {
+		ScanPolicy.save($scope.policy).then(
+			function () {
+				toastr.success($translate.instant('parameters_view.Policy_saved'));
+			},
+			function () {
+				toastr.error($translate.instant('parameters_view.Policy_not_saved'));
+			}
+		);
+	};
+
+	$scope.newSchedule = function () {
+		$scope.editedSchedule = {
+			id: null,
+			name: '',
+			path: '/',
+			days: [1, 2, 3, 4, 5],
+			at: new Date(1970, 0, 1, 22, 0),
+			profile_name: '',
+			enabled: true
+		};
+	};
+
+	$scope.editSchedule = function (schedule) {
+		var parts = schedule.time.split(':');
+
+		$scope.editedSchedule = angular.extend(angular.copy(schedule), {
+			at: new Date(1970, 0, 1, parseInt(parts[0], 10), parseInt(parts[1], 10))
+		});
+	};
+
+	$scope.toggleDay = function (day) {
+		var index = $scope.editedSchedule.days.indexOf(day);
+
+		if (index === -1) {
+			$scope.editedSchedule.days.push(day);
+		}
+		else {
+			$scope.editedSchedule.days.splice(index, 1);
+		}
+	};
+
+	$scope.saveSchedule = function () {
+		var edited = $scope.editedSchedule;
+
+		// An invalid time input leaves `at` undefined.
+		if (!edited.path || !edited.days.length || !(edited.at instanceof Date) || isNaN(edited.at.getTime())) {
+			return;
+		}
+
+		var schedule = {
+			id: edited.id || Date.now().toString(36),
+			name: edited.name,
+			path: edited.path,
+			days: edited.days.slice(),
+			time: pad(edited.at.getHours()) + ':' + pad(edited.at.getMinutes()),
+			profile_name: edited.profile_name,
+			enabled: edited.enabled
+		};
+
+		var schedules = $scope.policy.schedules;
+		for (var i = 0; i < schedules.length; i++) {
+			if (schedules[i].id === schedule.id) {
+				schedules[i] = schedule;
+				$scope.newSchedule();
+				return;
+			}
+		}
+		schedules.push(schedule);
+		$scope.newSchedule();
+	};
+
+	$scope.removeSchedule = function (schedule) {
+		$scope.policy.schedules.splice($scope.policy.schedules.indexOf(schedule), 1);
+		if ($scope.editedSchedule.id === schedule.id) {
+			$scope.newSchedule();
+		}
+	};
+
+	// The folder chooser of the General tab, see CustomScanController.
+	$scope.chooseQuarantinePath = function () {
+		var chooser = document.querySelector('#quarantinePath');
+		chooser.addEventListener("change", function () {
+			var path = this.value;
+			$scope.$apply(function () {
+				$scope.policy.quarantine_path = path;
+			});
+		}, false);
+	};
+
+	$scope.nextRun = function (schedule) {
+		return ScanPolicy.nextRun(schedule);
+	};
+
+	$scope.newSchedule();
+	$scope.loadPolicy();
 
   }]);
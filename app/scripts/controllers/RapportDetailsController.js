@@ -26,21 +26,29 @@ along with Armadito gui.  If not, see <http://www.gnu.org/licenses/>.
  * @name armaditoApp.controller:RapportDetailsController
  * @description
  * # RapportDetailsController
- * Controller of the armaditoApp
+ * Shows the report of a completed scan, read by ReportService while the
+ * modal is open.
  */
 angular.module('armaditoApp')
-  .controller('RapportDetailsController', ['$scope', '$uibModalInstance', 'items' ,
-  		function ($scope, $uibModalInstance, items) {
-	   	  $scope.items = items;
-		  $scope.selected = {
-		    item: $scope.items[0]
+  .controller('RapportDetailsController', ['$scope', '$uibModalInstance', 'ReportService', 'report',
+  		function ($scope, $uibModalInstance, ReportService, report) {
+
+		  $scope.report = report;
+		  $scope.viewer = ReportService.open(report.report_id);
+
+		  $scope.download = function () {
+		    ReportService.download(report.report_id);
 		  };
 
 		  $scope.ok = function () {
-		    $uibModalInstance.close($scope.selected.item);
+		    $uibModalInstance.close();
 		  };
 
 		  $scope.cancel = function () {
 		    $uibModalInstance.dismiss('cancel');
 		  };
+
+		  $scope.$on('$destroy', function () {
+		    $scope.viewer.close();
+		  });
   }]);
@@ -31,118 +31,258 @@ along with Armadito gui.  If not, see <http://www.gnu.org/licenses/>.
 
 angular.module('armaditoApp')
   .controller('ScanController',
-            ['$rootScope', '$scope', '$uibModal', 'ScanService', 'ScanData',
-    function ($rootScope,   $scope,   $uibModal,   ScanService,   ScanData)
+            ['$scope', '$interval', '$uibModal', 'ScanService', 'ScanData', 'ScanUpdateQueue', 'ScanProfiles', 'ScanMetrics', 'ReportService', 'DetectionTree', 'UiTrace', 'FleetService',
+    function ($scope,   $interval,   $uibModal,   ScanService,   ScanData,   ScanUpdateQueue,   ScanProfiles,   ScanMetrics,   ReportService,   DetectionTree,   UiTrace,   FleetService)
     {
-        $scope.filePathBeginLimit = 10;
-        $scope.filePathEndLimit = 40;
+        $scope.jobs = ScanService.jobs;
+        $scope.selected_job = null;
 
         $scope.synchronizeScopeWithFactory = function ()
         {
-            $scope.type = ScanData.data.type;
+            var selected = $scope.selected_job ? $scope.selected_job.data : ScanData;
+
             $scope.scan_progress = ScanData.data.progress;
-            $scope.scan_files = ScanData.data.files;
+            $scope.scan_files = resultsOf(selected.data.files);
             $scope.scanned_count = ScanData.data.scanned_count;
             $scope.suspicious_count = ScanData.data.suspicious_count;
             $scope.malware_count = ScanData.data.malware_count;
+            $scope.skipped_count = ScanData.data.skipped_count;
             $scope.displayed_file = ScanData.data.displayed_file;
-            $scope.path_to_scan = ScanData.data.path_to_scan;
-            $scope.canceled = ScanData.data.canceled;
+            $scope.display_file = ScanData.data.display_file;
+            $scope.canceled = selected.data.canceled;
+            $scope.running_count = ScanService.runningJobs().length;
+
+            if ($scope.show_tree)
+            {
+                $scope.tree_nodes = treeOf(selected.data.files);
+            }
+
+            if ($scope.show_metrics)
+            {
+                refreshMetrics();
+            }
         };
 
-        $scope.updateProgress = function (data)
+        // Filters, sort and grouping of the detections table. Views are
+        // kept up to date by the store, a new one is only needed when the
+        // query or the selected job changes.
+        $scope.results = { prefix: "", module_name: "", scan_status: "", scan_action: "", sort: "", desc: false, group: "" };
+        $scope.result_fields = ["path", "module_name", "scan_status", "scan_action"];
+        $scope.result_choices = {};
+        $scope.show_filters = false;
+
+        var results_view = null;
+
+        function isFiltered(query)
+        {
+            return !!(query.prefix || query.module_name || query.scan_status || query.scan_action
+                   || query.sort || query.group);
+        }
+
+        function resultsOf(files)
         {
-            if(data.path)
+            if (!isFiltered($scope.results))
             {
-                ScanData.setDisplayedFile(data.path);
+                results_view = null;
+                return files;
             }
 
-            ScanData.updateCounters(data.scanned_count,
-                           data.suspicious_count,
-                           data.malware_count,
-                           data.progress);
+            if (results_view === null || results_view.store !== files)
+            {
+                results_view = files.view(angular.copy($scope.results));
+            }
+
+            if ($scope.show_filters)
+            {
+                $scope.result_choices.module_name = files.values("module_name");
+                $scope.result_choices.scan_status = files.values("scan_status");
+                $scope.result_choices.scan_action = files.values("scan_action");
+            }
+
+            return results_view;
         }
 
-        $scope.addScannedFile = function (data)
+        $scope.toggleFilters = function ()
+        {
+            $scope.show_filters = !$scope.show_filters;
+            $scope.synchronizeScopeWithFactory();
+        };
+
+        $scope.clearResults = function ()
+        {
+            $scope.results = { prefix: "", module_name: "", scan_status: "", scan_action: "", sort: "", desc: false, group: "" };
+        };
+
+        $scope.$watch('results', function (results, previous)
         {
-            if(data.scan_status === 'malware'
-            || data.scan_status === 'suspicious')
+            if (results !== previous)
             {
-                ScanData.addScannedFile(data.path,
-                                               data.scan_status,
-                                               data.scan_action,
-                                               data.module_name,
-                                               data.module_report);
+                results_view = null;
+                $scope.synchronizeScopeWithFactory();
             }
+        }, true);
+
+        // Detections counted per directory, next to the table. Selecting a
+        // folder opens it and restricts the table to what lies below it.
+        $scope.show_tree = false;
+        $scope.tree_options = { expandOnClick: false, showIcon: true };
+        $scope.tree_nodes = [];
+
+        var detection_tree = null;
+
+        function treeOf(files)
+        {
+            if (detection_tree === null || detection_tree.store !== files)
+            {
+                detection_tree = DetectionTree.create(files);
+            }
+
+            return detection_tree.refresh();
         }
 
-        $scope.updateScanData = function (data)
+        $scope.toggleTree = function ()
         {
-            if(data.event_type === "DetectionEvent")
+            $scope.show_tree = !$scope.show_tree;
+            if (!$scope.show_tree)
             {
-                $scope.addScannedFile(data);
+                detection_tree = null;
+                $scope.tree_nodes = [];
             }
-            else if (data.event_type === "OnDemandProgressEvent")
+            $scope.synchronizeScopeWithFactory();
+        };
+
+        $scope.$on('selection-changed', function (e, node)
+        {
+            // Other trees, like the custom scan one, have no entry ids.
+            if (detection_tree === null || node.entry_id === undefined)
             {
-                $scope.updateProgress(data);
+                return;
             }
-            else if (data.event_type === "OnDemandCompletedEvent")
+
+            if (!node.expanded)
             {
-                // TODO
+                detection_tree.expand(node);
             }
+            $scope.results.prefix = node.full_path;
+        });
 
-            $scope.synchronizeScopeWithFactory();
-            $scope.$apply();
+        // The panel is refreshed every second as well, so that a scan stuck
+        // on one file shows it even when no event comes in.
+        var metrics_timer = null;
+
+        function refreshMetrics()
+        {
+            $scope.metrics = ScanMetrics.snapshot();
+            $scope.trace = UiTrace.enabled ? UiTrace.snapshot() : null;
         }
 
-        $scope.cancelScan = function ()
+        $scope.toggleMetrics = function ()
         {
-            if($scope.canceled == 0)
+            $scope.show_metrics = !$scope.show_metrics;
+
+            if ($scope.show_metrics)
+            {
+                refreshMetrics();
+                metrics_timer = $interval(refreshMetrics, 1000);
+            }
+            else
             {
-                ScanData.setCanceled();
+                $interval.cancel(metrics_timer);
+                metrics_timer = null;
             }
         };
 
-        $scope.removeEventListeners = function()
+        $scope.toggleTrace = function ()
         {
-            $rootScope.$$listeners.OnDemandProgressEvent=[];
-            $rootScope.$$listeners.DetectionEvent=[];
-            $rootScope.$$listeners.OnDemandCompletedEvent=[];
-        }
+            UiTrace.setEnabled(!UiTrace.enabled);
+            refreshMetrics();
+        };
 
-        $scope.addEventListeners = function()
+        $scope.$on('$destroy', function ()
         {
-            $rootScope.$on('OnDemandProgressEvent', function(event, data)
+            $interval.cancel(metrics_timer);
+        });
+
+        // A flush may come from within a digest (completion events are
+        // flushed at once), so the scope is only synchronized in the next one.
+        $scope.$on('$destroy', ScanUpdateQueue.onFlush(function ()
+        {
+            $scope.$applyAsync(function ()
             {
-                $scope.updateScanData(data);
+                var started = UiTrace.begin("synchronize");
+
+                $scope.synchronizeScopeWithFactory();
+                UiTrace.end("synchronize", started);
+
+                started = UiTrace.begin("digest");
+                $scope.$$postDigest(function ()
+                {
+                    UiTrace.end("digest", started);
+                });
             });
+        }));
+
+        // Scans running on the hosts of the fleet, see FleetService.
+        FleetService.start();
+        $scope.fleet_scans = FleetService.rollup().scans;
+
+        $scope.$on('FleetChanged', function ()
+        {
+            $scope.fleet_scans = FleetService.rollup().scans;
+        });
+
+        $scope.selectJob = function (job)
+        {
+            $scope.selected_job = job;
+            $scope.synchronizeScopeWithFactory();
+        };
 
-            $rootScope.$on('DetectionEvent', function(event, data)
+        $scope.cancelScan = function ()
+        {
+            if($scope.canceled == 0 && $scope.selected_job)
             {
-                $scope.updateScanData(data);
-            });
+                ScanService.cancelScan($scope.selected_job);
+                $scope.canceled = 1;
+            }
+        };
 
-            $rootScope.$on('OnDemandCompletedEvent', function(event, data)
+        $scope.resumeScan = function ()
+        {
+            if ($scope.selected_job)
             {
-                $scope.updateScanData(data);
-            });
-        }
+                ScanService.resumeScan($scope.selected_job);
+            }
+        };
 
         $scope.prepareFactoryForScan = function()
         {
-            ScanData.reset();
+            // A new scan started while others still run is added to them.
+            if (ScanService.runningJobs().length === 0)
+            {
+                ScanUpdateQueue.clear();
+                ScanService.clearJobs();
+                ScanData.reset();
+                ScanMetrics.reset();
+            }
             ScanData.setScanConf($scope.path_to_scan, $scope.type);
-            $scope.synchronizeScopeWithFactory();
-        }
+        };
 
         $scope.startScan = function ()
         {
+            $scope.prepareFactoryForScan();
+            var options = {};
 
+            if ($scope.type === "scan_view.Incremental_scan")
+            {
+                options = ScanService.incrementalOptions($scope.path_to_scan);
+            }
+            else if ($scope.type === "scan_view.Custom_scan" && $scope.scanOptions)
+            {
+                options.profile = ScanProfiles.toRequest($scope.scanOptions);
+            }
 
-            $scope.prepareFactoryForScan();
-            $scope.removeEventListeners();
-            $scope.addEventListeners();
-            ScanService.newScan($scope.path_to_scan);
+            $scope.selected_job = ScanService.newScan($scope.path_to_scan, $scope.type, options);
+            $scope.synchronizeScopeWithFactory();
         };
 
         $scope.fullScan = function ()
@@ -157,6 +297,12 @@ angular.module('armaditoApp')
             $scope.path_to_scan = "/home";
         };
 
+        $scope.incrementalScan = function ()
+        {
+            $scope.type = "scan_view.Incremental_scan";
+            $scope.path_to_scan = "/";
+        };
+
         $scope.customScan = function ()
         {
             $scope.type = "scan_view.Custom_scan";
@@ -190,21 +336,55 @@ angular.module('armaditoApp')
             );
         };
 
-        $scope.truncate = function (string, max_length)
+        // The daemon keeps the report of a completed scan under its id.
+        $scope.downloadReport = function ()
         {
-            if (string.length <= max_length){
-                return string;
-            }
+            ReportService.download($scope.selected_job.id);
+        };
 
-            var separator = '...',
-                chars_to_show = max_length - separator.length,
-                front_chars = Math.ceil(chars_to_show/2),
-                back_chars = Math.floor(chars_to_show/2);
+        $scope.openDetection = function (index)
+        {
+            var selected = $scope.selected_job ? $scope.selected_job.data : ScanData;
 
-            return string.substr(0, front_chars) +
-                 separator + string.substr(string.length - back_chars);
+            selected.getScannedFile(index).then(
+                function (file)
+                {
+                    $uibModal.open({
+                        animation: $scope.animationsEnabled,
+                        templateUrl: 'views/DetailRapportModal.html',
+                        controller: 'DetailRapportModalController',
+                        size: 'sm',
+                        resolve:
+                        {
+                            items: function ()
+                            {
+                                return [file.path, file.scan_status, file.scan_action,
+                                        file.module_name, file.module_report];
+                            }
+                        }
+                    });
+                },
+                function (error)
+                {
+                    console.error("Error when loading detection " + index + " : " + error);
+                }
+            );
         };
 
+        // The type and path of the last scan stay selected.
+        $scope.type = ScanData.data.type;
+        $scope.path_to_scan = ScanData.data.path_to_scan;
+
+        var running = ScanService.runningJobs();
+        if (running.length > 0)
+        {
+            $scope.selected_job = running[running.length - 1];
+        }
+        else if (ScanService.jobs.length > 0)
+        {
+            $scope.selected_job = ScanService.jobs[ScanService.jobs.length - 1];
+        }
+
         $scope.synchronizeScopeWithFactory();
     }
 ]);
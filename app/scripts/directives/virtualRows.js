@@ -0,0 +1,135 @@
+/***
+
+Copyright (C) 2015, 2016 Teclib'
+
+This file is part of Armadito gui.
+
+Armadito gui is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Armadito gui is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Armadito gui.  If not, see <http://www.gnu.org/licenses/>.
+
+***/
+
+'use strict';
+
+/**
+ * @ngdoc directive
+ * @name armaditoApp.directive:virtualRows
+ * @description
+ * # virtualRows
+ * Put on a scrollable container to only render the rows that are visible.
+ * The collection only needs `length` and `slice(start, end)`, and may bump
+ * a `version` field when rows already in the window change. The visible
+ * window is exposed as `virtual.rows`, with `virtual.before` and
+ * `virtual.after` giving the heights (px) of the spacers around it.
+ *
+ *   <tbody virtual-rows="scan_files" row-height="30">
+ *     <tr ng-style="{height: virtual.before + 'px'}"></tr>
+ *     <tr ng-repeat="file in virtual.rows track by (virtual.start + $index)">...</tr>
+ *     <tr ng-style="{height: virtual.after + 'px'}"></tr>
+ *   </tbody>
+ */
+angular.module('armaditoApp')
+    .directive('virtualRows', ['$window', '$timeout', function ($window, $timeout)
+    {
+        return {
+            restrict: 'A',
+            link: function (scope, element, attrs)
+            {
+                var container = element[0];
+                var row_height = parseInt(attrs.rowHeight, 10) || 30;
+                var overscan = parseInt(attrs.overscan, 10) || 10;
+                var scroll_pending = false;
+                var scroll_frame = null;
+                var scroll_timer = null;
+
+                scope.virtual = {
+                    rows: [],
+                    start: 0,
+                    before: 0,
+                    after: 0
+                };
+
+                function update()
+                {
+                    var rows = scope.$eval(attrs.virtualRows);
+                    var length = rows ? rows.length : 0;
+                    var visible = Math.ceil(container.clientHeight / row_height) + 2 * overscan;
+                    var start = Math.floor(container.scrollTop / row_height) - overscan;
+
+                    start = Math.max(0, Math.min(start, length - visible));
+                    var end = Math.min(length, start + visible);
+
+                    scope.virtual.start = start;
+                    scope.virtual.rows = length ? rows.slice(start, end) : [];
+                    scope.virtual.before = start * row_height;
+                    scope.virtual.after = (length - end) * row_height;
+                }
+
+                function onFrame()
+                {
+                    var previous = scope.virtual.start;
+
+                    scroll_pending = false;
+                    scroll_frame = null;
+                    scroll_timer = null;
+                    update();
+
+                    // Only the rows of this scope changed, no need for a root digest.
+                    if (previous !== scope.virtual.start)
+                    {
+                        scope.$digest();
+                    }
+                }
+
+                function onScroll()
+                {
+                    if (scroll_pending)
+                    {
+                        return;
+                    }
+
+                    scroll_pending = true;
+
+                    // About one frame without requestAnimationFrame, with
+                    // the same digest of this scope only.
+                    if ($window.requestAnimationFrame)
+                    {
+                        scroll_frame = $window.requestAnimationFrame(onFrame);
+                    }
+                    else
+                    {
+                        scroll_timer = $timeout(onFrame, 16, false);
+                    }
+                }
+
+                scope.$watch(attrs.virtualRows, update);
+                scope.$watch(attrs.virtualRows + '.length', update);
+                scope.$watch(attrs.virtualRows + '.version', update);
+
+                element.on('scroll', onScroll);
+                scope.$on('$destroy', function ()
+                {
+                    element.off('scroll', onScroll);
+                    if (scroll_frame !== null)
+                    {
+                        $window.cancelAnimationFrame(scroll_frame);
+                    }
+                    if (scroll_timer !== null)
+                    {
+                        $timeout.cancel(scroll_timer);
+                    }
+                });
+            }
+        };
+    }
+]);
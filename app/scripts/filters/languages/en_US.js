@@ -21,7 +21,27 @@
     "Status_up_to_date" : "Up-to-date",
 	  "Status_critical" : "critical",
 	  "Status_late" : "late",
-	  "Status_unavailable" : "unavailable"
+	  "Status_unavailable" : "unavailable",
+	  "Update_now" : "Update the databases now",
+	  "Update_pending" : "Waiting",
+	  "Update_downloading" : "Downloading",
+	  "Update_applying" : "Applying",
+	  "Update_done" : "Updated",
+	  "Update_failed" : "Update failed",
+	  "Update_failed_modules" : "Update failed for {{modules}}",
+	  "Update_mode_delta" : "delta",
+	  "Update_mode_full" : "full database",
+    "Fleet" : {
+      "Title" : "Fleet",
+      "Hosts" : "{{count}} hosts, {{online}} online",
+      "Scans" : "{{running}} scans, {{scanned_count}} files, {{malware_count}} malicious, {{suspicious_count}} suspect ({{progress}}%)",
+      "Host_url" : "http://host:8888",
+      "Add_host" : "Add host",
+      "Hosts_with_status" : "{{count}} hosts {{status}}",
+      "State_online" : "online",
+      "State_connecting" : "connecting",
+      "State_offline" : "unreachable"
+    }
   },
   "scan_view" : {
     "ButtonTitle" : "SCAN",
@@ -32,6 +52,7 @@
     "Choose_scan_type" : "Choose type",
     "Full_scan" : "FULL",
     "Quick_scan" : "QUICK",
+    "Incremental_scan" : "INCREMENTAL",
     "Custom_scan" : "CUSTOM",
     "Scanned" : "Scanned",
     "Malicious" : "Malicious",
@@ -45,7 +66,41 @@
     "Heuristic_mode" : "Heuristic mode",
     "Scan_archive" : "Scan archive",
     "Add_file_to_exclude" : "Select a file to exclude",
-    "Excluded_files" : "Excluded files"
+    "Excluded_files" : "Excluded files",
+    "Canceling" : "Canceling...",
+    "Canceled" : "Canceled",
+    "Resume" : "Resume",
+    "Interrupted" : "Interrupted",
+    "Skipped" : "Unchanged files skipped",
+    "Profile" : "Scan profile",
+    "Profile_name" : "Profile name",
+    "Save_profile" : "Save",
+    "Exclusion_placeholder" : "Exclude a path prefix or a glob, e.g. */node_modules",
+    "Metrics" : "Scan metrics",
+    "Files_per_second" : "Files/s",
+    "MB_per_second" : "MB/s",
+    "ETA" : "Remaining",
+    "Current_file_time" : "On current file",
+    "Event_lag" : "Event lag",
+    "Events_per_digest" : "Events/refresh",
+    "Digest_time" : "Refresh time",
+    "Missed_events" : "Lost events",
+    "Trace" : "Trace the UI (avg / max)",
+    "Download_report" : "Download the scan report",
+    "Filter" : "Filter and sort the detections",
+    "Directory_tree" : "Detections per directory",
+    "Path_prefix" : "Under path...",
+    "All_modules" : "All modules",
+    "All_statuses" : "All statuses",
+    "All_actions" : "All actions",
+    "Sort_by" : "Sort by",
+    "Arrival_order" : "Detection order",
+    "Group_by" : "Group by",
+    "No_grouping" : "No grouping",
+    "Field_path" : "Folder",
+    "Field_module_name" : "Module",
+    "Field_scan_status" : "Status",
+    "Field_scan_action" : "Action"
   },
   "journal_view" : {
   	"ButtonTitle" : "JOURNAL",
@@ -57,7 +112,12 @@
       "Status" : "Status",
       "User" : "User",
       "Clear" : "CLEAR",
-      "Refresh" : "REFRESH"
+      "Refresh" : "REFRESH",
+      "From" : "From",
+      "To" : "To",
+      "All_types" : "All types",
+      "More" : "More...",
+      "No_entries" : "No entry"
     },
     "Threat_detected_tab" : {
       "Title" : "ALERTS",
@@ -74,7 +134,23 @@
       "Date" : "Date",
       "Remove" : "Remove",
       "Restore" : "Restore",
+      "Selected" : "{{count}} selected",
+      "Select_all" : "Select all {{count}} files",
+      "Confirm_title" : "Quarantine",
+      "Confirm_delete" : "Are you sure you want to delete {{count}} quarantined files?",
+      "Confirm_clear" : "Are you sure you want to delete all {{count}} quarantined files?",
+      "Operation_done" : "{{done}} files processed.",
+      "Operation_failed" : "{{done}} files processed, {{failed}} failed.",
+      "Operation_error" : "The daemon refused the operation (error {{status}}).",
       "Clear" : "CLEAR"
+    },
+    "Report" : {
+      "Title" : "Scan report",
+      "Open" : "Open the scan report",
+      "Download" : "Download",
+      "Loading" : "Reading the report... {{loaded}} detections",
+      "Loaded" : "{{loaded}} detections",
+      "Error" : "The report could not be read"
     }
   },
   "parameters_view" : {
@@ -87,7 +163,39 @@
     "Quarantine_repertory" : "Quarantine folder",
     "Select_folder" : "Select folder",
     "Cancel" : "Cancel",
-    "Apply" : "Apply"
+    "Apply" : "Apply",
+    "Scan_profiles" : "PROFILES",
+    "Profile_name" : "Name",
+    "Heuristic_mode" : "Heuristic",
+    "Scan_archive" : "Archives",
+    "Exclusions" : "Exclusions",
+    "New_profile" : "New profile",
+    "Scheduled_scans" : "SCHEDULES",
+    "Throttling" : "Scan throttling",
+    "Cpu_priority" : "CPU priority",
+    "Io_priority" : "Disk priority",
+    "Priority_normal" : "Normal",
+    "Priority_low" : "Low",
+    "Priority_idle" : "When idle",
+    "Max_files_per_second" : "Maximum files per second",
+    "No_limit" : "No limit",
+    "Pause_on_battery" : "Pause on battery",
+    "Pause_load_above" : "Pause when the load is above",
+    "New_schedule" : "New scheduled scan",
+    "Schedule_name" : "Name",
+    "Default_profile" : "Default profile",
+    "Enabled" : "Enabled",
+    "Day_0" : "Sun",
+    "Day_1" : "Mon",
+    "Day_2" : "Tue",
+    "Day_3" : "Wed",
+    "Day_4" : "Thu",
+    "Day_5" : "Fri",
+    "Day_6" : "Sat",
+    "Policy_saved" : "The scan policy was sent to the daemon.",
+    "Policy_not_saved" : "The scan policy could not be saved.",
+    "Save" : "Save",
+    "Remove" : "Remove"
 
   },
   "statistics_view" : {
@@ -21,7 +21,27 @@
 	  "Status_up_to_date" : "à jour",
 	  "Status_critical" : "critique",
 	  "Status_late" : "tardif",
-	  "Status_unavailable" : "indisponible"
+	  "Status_unavailable" : "indisponible",
+	  "Update_now" : "Mettre à jour les bases maintenant",
+	  "Update_pending" : "En attente",
+	  "Update_downloading" : "Téléchargement",
+	  "Update_applying" : "Installation",
+	  "Update_done" : "À jour",
+	  "Update_failed" : "Échec de la mise à jour",
+	  "Update_failed_modules" : "Échec de la mise à jour de {{modules}}",
+	  "Update_mode_delta" : "différentielle",
+	  "Update_mode_full" : "base complète",
+    "Fleet" : {
+      "Title" : "Parc",
+      "Hosts" : "{{count}} machines, {{online}} connectées",
+      "Scans" : "{{running}} analyses, {{scanned_count}} fichiers, {{malware_count}} malveillants, {{suspicious_count}} suspects ({{progress}}%)",
+      "Host_url" : "http://machine:8888",
+      "Add_host" : "Ajouter",
+      "Hosts_with_status" : "{{count}} machines {{status}}",
+      "State_online" : "connectée",
+      "State_connecting" : "connexion",
+      "State_offline" : "injoignable"
+    }
   },
   "scan_view" : {
     "ButtonTitle" : "ANALYSE",
@@ -32,6 +52,7 @@
     "Choose_scan_type" : "Choisissez le type d'analyse",
     "Full_scan" : "COMPLÈTE",
     "Quick_scan" : "RAPIDE",
+    "Incremental_scan" : "INCRÉMENTALE",
     "Custom_scan" : "PERSONNALISÉE",
     "Scanned" : "Analysés",
     "Malicious" : "Malveillants",
@@ -45,7 +66,41 @@
     "Heuristic_mode" : "Mode heuristique",
     "Scan_archive" : "Scan d'archives",
     "Add_file_to_exclude" : "Selectionnez fichier à exclure",
-    "Excluded_files" : "Fichiers exclus"
+    "Excluded_files" : "Fichiers exclus",
+    "Canceling" : "Annulation...",
+    "Canceled" : "Annulée",
+    "Resume" : "Reprendre",
+    "Interrupted" : "Interrompue",
+    "Skipped" : "Fichiers inchangés ignorés",
+    "Profile" : "Profil d'analyse",
+    "Profile_name" : "Nom du profil",
+    "Save_profile" : "Enregistrer",
+    "Exclusion_placeholder" : "Exclure un préfixe de chemin ou un motif, ex. */node_modules",
+    "Metrics" : "Métriques d'analyse",
+    "Files_per_second" : "Fichiers/s",
+    "MB_per_second" : "Mo/s",
+    "ETA" : "Restant",
+    "Current_file_time" : "Sur le fichier courant",
+    "Event_lag" : "Retard des événements",
+    "Events_per_digest" : "Événements/rafraîchissement",
+    "Digest_time" : "Durée de rafraîchissement",
+    "Missed_events" : "Événements perdus",
+    "Trace" : "Tracer l'interface (moy. / max)",
+    "Download_report" : "Télécharger le rapport de scan",
+    "Filter" : "Filtrer et trier les détections",
+    "Directory_tree" : "Détections par répertoire",
+    "Path_prefix" : "Sous le chemin...",
+    "All_modules" : "Tous les modules",
+    "All_statuses" : "Tous les statuts",
+    "All_actions" : "Toutes les actions",
+    "Sort_by" : "Trier par",
+    "Arrival_order" : "Ordre de détection",
+    "Group_by" : "Grouper par",
+    "No_grouping" : "Sans regroupement",
+    "Field_path" : "Dossier",
+    "Field_module_name" : "Module",
+    "Field_scan_status" : "Statut",
+    "Field_scan_action" : "Action"
   },
   "journal_view" : {
     "ButtonTitle" : "JOURNAL",
@@ -57,7 +112,12 @@
       "Status" : "Statut",
       "User" : "Utilisateur",
       "Clear" : "NETTOYER",
-      "Refresh" : "RAFRAICHIR"
+      "Refresh" : "RAFRAICHIR",
+      "From" : "Du",
+      "To" : "Au",
+      "All_types" : "Tous les types",
+      "More" : "Plus...",
+      "No_entries" : "Aucune entrée"
     },
     "Threat_detected_tab" : {
       "Title" : "MENACES DÉTECTÉES",
@@ -74,7 +134,23 @@
       "Date" : "Date",
       "Remove" : "Supprimer",
       "Restore" : "Restaurer",
+      "Selected" : "{{count}} sélectionné(s)",
+      "Select_all" : "Sélectionner les {{count}} fichiers",
+      "Confirm_title" : "Quarantaine",
+      "Confirm_delete" : "Êtes-vous sûr de vouloir supprimer {{count}} objets de la quarantaine ?",
+      "Confirm_clear" : "Êtes-vous sûr de vouloir supprimer les {{count}} objets de la quarantaine ?",
+      "Operation_done" : "{{done}} fichiers traités.",
+      "Operation_failed" : "{{done}} fichiers traités, {{failed}} en échec.",
+      "Operation_error" : "Le démon a refusé l'opération (erreur {{status}}).",
       "Clear" : "NETTOYER"
+    },
+    "Report" : {
+      "Title" : "Rapport de scan",
+      "Open" : "Ouvrir le rapport de scan",
+      "Download" : "Télécharger",
+      "Loading" : "Lecture du rapport... {{loaded}} détections",
+      "Loaded" : "{{loaded}} détections",
+      "Error" : "Le rapport n'a pas pu être lu"
     }
   },
   "parameters_view" : {
@@ -87,7 +163,39 @@
     "Quarantine_repertory" : "Repertoire de quarantaine",
     "Select_folder" : "Selectionnez un dossier",
     "Cancel" : "Annuler",
-    "Apply" : "Valider"
+    "Apply" : "Valider",
+    "Scan_profiles" : "PROFILS",
+    "Profile_name" : "Nom",
+    "Heuristic_mode" : "Heuristique",
+    "Scan_archive" : "Archives",
+    "Exclusions" : "Exclusions",
+    "New_profile" : "Nouveau profil",
+    "Scheduled_scans" : "PLANIFICATION",
+    "Throttling" : "Limitation des scans",
+    "Cpu_priority" : "Priorité CPU",
+    "Io_priority" : "Priorité disque",
+    "Priority_normal" : "Normale",
+    "Priority_low" : "Basse",
+    "Priority_idle" : "Au repos",
+    "Max_files_per_second" : "Fichiers par seconde au maximum",
+    "No_limit" : "Sans limite",
+    "Pause_on_battery" : "Pause sur batterie",
+    "Pause_load_above" : "Pause quand la charge dépasse",
+    "New_schedule" : "Nouveau scan planifié",
+    "Schedule_name" : "Nom",
+    "Default_profile" : "Profil par défaut",
+    "Enabled" : "Activé",
+    "Day_0" : "Dim",
+    "Day_1" : "Lun",
+    "Day_2" : "Mar",
+    "Day_3" : "Mer",
+    "Day_4" : "Jeu",
+    "Day_5" : "Ven",
+    "Day_6" : "Sam",
+    "Policy_saved" : "La politique de scan a été envoyée au service.",
+    "Policy_not_saved" : "La politique de scan n'a pas pu être enregistrée.",
+    "Save" : "Enregistrer",
+    "Remove" : "Supprimer"
 
   },
   "statistics_view" : {
@@ -0,0 +1,259 @@
+/***
+
+Copyright (C) 2015, 2016 Teclib'
+
+This file is part of Armadito gui.
+
+Armadito gui is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Armadito gui is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Armadito gui.  If not, see <http://www.gnu.org/licenses/>.
+
+***/
+
+'use strict';
+
+/**
+ * @ngdoc service
+ * @name armaditoApp.ApiSession
+ * @description
+ * # ApiSession
+ * One daemon session shared by all services. Registers lazily on the
+ * first request, reuses the token afterwards, registers again when the
+ * daemon rejects it and unregisters when the application is closed.
+ * The session also owns the single event channel of its token: services
+ * subscribe to it instead of polling /api/event on their own. Events lost
+ * by the channel are announced to subscribers as an EventGapEvent, its
+ * losses and recoveries as a ChannelStateEvent with `connected`.
+ * forHost() gives sessions with the same interface for other daemons,
+ * their request URLs and channel prefixed with the daemon's origin.
+ */
+angular.module('armaditoApp')
+    .service('ApiSession', ['$http', '$q', '$timeout', '$window', 'EventChannel', function ($http, $q, $timeout, $window, EventChannel) {
+
+        var sessions = {};
+
+        // base_url is "" for the daemon serving the UI, the origin of
+        // another daemon otherwise, see forHost().
+        function createSession(base_url)
+        {
+            var session = {};
+
+            session.token = null;
+
+            var registering = null;
+            var channel = null;
+            var channel_retry = null;
+            var register_attempt = 0;
+            var subscribers = [];
+
+            function isAuthError(response)
+            {
+                return response.status === 401 || response.status === 403;
+            }
+
+            session.register = function ()
+            {
+                if (session.token !== null)
+                {
+                    return $q.when(session.token);
+                }
+
+                if (registering === null)
+                {
+                    registering = $http({ method: 'GET', url: base_url + '/api/register' }).then(
+                        function (response)
+                        {
+                            registering = null;
+                            session.token = response.data.token;
+                            return session.token;
+                        },
+                        function (error)
+                        {
+                            registering = null;
+                            console.error("Error when registering to the daemon : " + error.status);
+                            return $q.reject(error);
+                        }
+                    );
+                }
+
+                return registering;
+            };
+
+            // Forgets a token the daemon does not know anymore.
+            session.invalidate = function (token)
+            {
+                if (session.token === token)
+                {
+                    session.token = null;
+                }
+            };
+
+            session.request = function (config)
+            {
+                function send(token)
+                {
+                    var request = angular.extend({}, config, { url: base_url + config.url });
+                    request.headers = angular.extend({ "X-Armadito-Token": token }, config.headers);
+                    return $http(request);
+                }
+
+                return session.register().then(function (token)
+                {
+                    return send(token).catch(function (error)
+                    {
+                        if (!isAuthError(error))
+                        {
+                            return $q.reject(error);
+                        }
+
+                        session.invalidate(token);
+                        return session.register().then(send);
+                    });
+                });
+            };
+
+            function dispatch(receivedEvent)
+            {
+                // Subscribers may unsubscribe while being called.
+                var current = subscribers.slice();
+                for (var i = 0; i < current.length; i++)
+                {
+                    current[i](receivedEvent);
+                }
+            }
+
+            function dispatchGap(first_seq, last_seq)
+            {
+                console.warn("Events " + first_seq + " to " + last_seq + " were lost");
+                dispatch({ event_type: "EventGapEvent", first_seq: first_seq, last_seq: last_seq });
+            }
+
+            function dispatchState(connected)
+            {
+                dispatch({ event_type: "ChannelStateEvent", connected: connected });
+            }
+
+            function openChannel()
+            {
+                if (channel_retry !== null)
+                {
+                    return;
+                }
+
+                session.register().then(
+                    function (token)
+                    {
+                        register_attempt = 0;
+
+                        if (channel === null && subscribers.length > 0)
+                        {
+                            channel = EventChannel.open(token, dispatch, function ()
+                            {
+                                // Watches tied to the old token are gone.
+                                channel = null;
+                                session.invalidate(token);
+                                dispatchState(false);
+                                openChannel();
+                            }, dispatchGap, base_url, dispatchState);
+                        }
+                    },
+                    function ()
+                    {
+                        dispatchState(false);
+
+                        // The daemon may be starting or overloaded, keep trying
+                        // for as long as someone listens.
+                        channel_retry = $timeout(function ()
+                        {
+                            channel_retry = null;
+                            if (subscribers.length > 0)
+                            {
+                                openChannel();
+                            }
+                        }, EventChannel.retryDelay(register_attempt++), false);
+                    }
+                );
+            }
+
+            session.subscribe = function (handler)
+            {
+                subscribers.push(handler);
+                openChannel();
+
+                return function ()
+                {
+                    var index = subscribers.indexOf(handler);
+                    if (index !== -1)
+                    {
+                        subscribers.splice(index, 1);
+                    }
+
+                    if (subscribers.length === 0 && channel !== null)
+                    {
+                        channel.close();
+                        channel = null;
+                    }
+                };
+            };
+
+            session.unregister = function ()
+            {
+                if (session.token === null)
+                {
+                    return;
+                }
+
+                if (channel !== null)
+                {
+                    channel.close();
+                    channel = null;
+                }
+
+                // Synchronous, the page is going away.
+                var xmlhttp = new XMLHttpRequest();
+                xmlhttp.open("GET", base_url + "/api/unregister", false);
+                xmlhttp.setRequestHeader("X-Armadito-Token", session.token);
+                try {
+                    xmlhttp.send(null);
+                }
+                catch(e)
+                {
+                    console.error("Error when unregistering : " + e);
+                }
+                session.token = null;
+            };
+
+            return session;
+        }
+
+        var factory = createSession("");
+
+        // Sessions of other daemons, one per origin, for the fleet view.
+        factory.forHost = function (base_url)
+        {
+            base_url = base_url.replace(/\/+$/, "");
+
+            if (!sessions.hasOwnProperty(base_url))
+            {
+                sessions[base_url] = createSession(base_url);
+            }
+
+            return sessions[base_url];
+        };
+
+        // Only the local session is unregistered on unload: one synchronous
+        // request per fleet host would hold the window for too long.
+        $window.addEventListener("unload", factory.unregister);
+
+        return factory;
+    }
+]);
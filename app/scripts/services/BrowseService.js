@@ -6,32 +6,137 @@
  * @description
  * # BrowseService
  * Service in the armaditoApp.
+ * Directory listings are fetched page by page and kept in a small LRU
+ * cache keyed by path and offset. A cached page younger than `max_age`
+ * is served as is, an older one is revalidated with its ETag.
  */
 angular.module('armaditoApp')
-	.service('BrowseService', function ($http)
+	.service('BrowseService', ['$q', 'ApiSession', function ($q, ApiSession)
 	{
-	  	var BrowseService = {
-	  		browse:
-	  		function(path)
-	  		{
-		     	var promise = $http(
-			    {
-		      		method: 'GET',
-		      		url: '/api/browse',
-		      		headers: {
-    					"Content-Type": "application/json"
-    				},
-    				params : {path : path}
+		var cache = {};
+		var cache_order = [];
+
+		function cacheKey(path, offset)
+		{
+			return path + "\n" + offset;
+		}
+
+		function cacheGet(key)
+		{
+			var entry = cache[key];
+
+			if (entry)
+			{
+				cache_order.splice(cache_order.indexOf(key), 1);
+				cache_order.push(key);
+			}
+			return entry;
+		}
+
+		function cachePut(key, entry)
+		{
+			if (cache[key])
+			{
+				cache_order.splice(cache_order.indexOf(key), 1);
+			}
+
+			cache[key] = entry;
+			cache_order.push(key);
+
+			while (cache_order.length > BrowseService.cache_size)
+			{
+				delete cache[cache_order.shift()];
+			}
+		}
+
+		var BrowseService = {
+			page_size: 500,
+			cache_size: 128,
+			max_age: 5000,
+
+			// Resolves with {path, content, next_offset}; next_offset is
+			// null on the last page.
+			browsePage:
+			function(path, offset)
+			{
+				var key = cacheKey(path, offset || 0);
+				var entry = cacheGet(key);
+				var headers = {
+					"Content-Type": "application/json"
+				};
+
+				if (entry && Date.now() - entry.time < BrowseService.max_age)
+				{
+					return $q.when(entry.data);
+				}
+
+				if (entry && entry.etag)
+				{
+					headers["If-None-Match"] = entry.etag;
+				}
+
+				return ApiSession.request(
+				{
+					method: 'GET',
+					url: '/api/browse',
+					headers: headers,
+					params : {path : path, offset : offset || 0, limit : BrowseService.page_size}
+				}
+				).then(
+					function (response)
+					{
+						var data = response.data;
+
+						if (data.next_offset === undefined)
+						{
+							data.next_offset = null;
+						}
+
+						cachePut(key, {
+							data: data,
+							etag: response.headers('ETag'),
+							time: Date.now()
+						});
+						return data;
+					},
+					function (error)
+					{
+						if (error.status === 304 && entry)
+						{
+							entry.time = Date.now();
+							return entry.data;
+						}
+						return $q.reject(error);
+					}
+				);
+			},
+
+			browse:
+			function(path)
+			{
+				return BrowseService.browsePage(path, 0);
+			},
+
+			// Warms the cache, errors are of no interest here.
+			prefetch:
+			function(path)
+			{
+				BrowseService.browsePage(path, 0).catch(angular.noop);
+			},
+
+			invalidate:
+			function(path)
+			{
+				for (var i = cache_order.length - 1; i >= 0; i--)
+				{
+					if (cache_order[i].indexOf(path + "\n") === 0)
+					{
+						delete cache[cache_order[i]];
+						cache_order.splice(i, 1);
+					}
 				}
-			    ).then(
-			        function (response)
-			        {
-			            return response.data;
-		        	}
-		    	);
-		      	return promise;
-		    }
+			}
 		};
 		return BrowseService;
 	}
-);
+]);
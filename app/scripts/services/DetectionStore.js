@@ -0,0 +1,827 @@
+/***
+
+Copyright (C) 2015, 2016 Teclib'
+
+This file is part of Armadito gui.
+
+Armadito gui is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Armadito gui is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Armadito gui.  If not, see <http://www.gnu.org/licenses/>.
+
+***/
+
+'use strict';
+
+/**
+ * @ngdoc service
+ * @name armaditoApp.DetectionStore
+ * @description
+ * # DetectionStore
+ * Columnar, memory-bounded storage for scan detections.
+ * Repeated strings (module name, scan status, scan action) are interned
+ * and stored as ids. Once the resident rows exceed `max_bytes`, the
+ * oldest ones are spilled to IndexedDB and read back page by page; when
+ * IndexedDB cannot be opened, rows stay in memory.
+ * A store looks like a read-only array to its users: `length`,
+ * `slice(start, end)` and `get(index)`, plus `push(file)`.
+ * Rows carry a `key` unique across stores, and go through the optional
+ * `decorate(row)` of the store once when they are read.
+ *
+ * The interned ids and the directory of every row stay in memory, spilled
+ * or not, along with one posting list of row indexes per value, kept up
+ * to date by `push`. `view(query)` builds on them a filtered, sorted and
+ * grouped view that also looks like an array, and only looks at the rows
+ * pushed since it was last read.
+ */
+angular.module('armaditoApp')
+    .service('DetectionStore', ['$rootScope', '$q', '$window', function ($rootScope, $q, $window) {
+
+        var factory = {};
+
+        factory.max_bytes = 8 * 1024 * 1024;
+        factory.page_size = 256;
+
+        var DB_NAME = "armadito-detections";
+        var OBJECT_STORE = "detections";
+        var ROW_OVERHEAD = 48;
+
+        // Pages read back from IndexedDB kept per store.
+        var MAX_PAGES = 8;
+
+        // Records are keyed by [store id, row index], store ids starting
+        // at the time they were created. Other tabs share the database:
+        // only stores older than this, left by a session that ended
+        // without disposing them, are removed when it is opened.
+        var STALE_AGE = 7 * 24 * 3600 * 1000;
+
+        // Fields a view can filter, sort or group on: the column of ids and
+        // the table of strings they point to. Paths are only indexed by
+        // directory, their file names spill with the rest of the row.
+        var FIELDS = {
+            path: { ids: "dir_ids", strings: "dirs" },
+            module_name: { ids: "module_ids", strings: "strings" },
+            scan_status: { ids: "status_ids", strings: "strings" },
+            scan_action: { ids: "action_ids", strings: "strings" }
+        };
+        var next_store_id = Date.now();
+        var database = null;
+        var database_failed = false;
+
+        function openDatabase()
+        {
+            if (database !== null)
+            {
+                return database;
+            }
+
+            var deferred = $q.defer();
+            database = deferred.promise;
+
+            if (!$window.indexedDB)
+            {
+                database_failed = true;
+                deferred.reject("IndexedDB is not available");
+                return database;
+            }
+
+            var request = $window.indexedDB.open(DB_NAME, 1);
+
+            request.onupgradeneeded = function ()
+            {
+                request.result.createObjectStore(OBJECT_STORE);
+            };
+            request.onsuccess = function ()
+            {
+                var db = request.result;
+                var stale = $window.IDBKeyRange.upperBound([Date.now() - STALE_AGE]);
+
+                db.transaction(OBJECT_STORE, "readwrite").objectStore(OBJECT_STORE).delete(stale);
+                deferred.resolve(db);
+            };
+            request.onerror = function ()
+            {
+                console.error("Error when opening detection database : " + request.error);
+                database_failed = true;
+                deferred.reject(request.error);
+            };
+
+            return database;
+        }
+
+        function Store(options)
+        {
+            options = options || {};
+
+            this.id = next_store_id++;
+            this.max_bytes = options.max_bytes || factory.max_bytes;
+            this.decorate = options.decorate || angular.noop;
+            this.length = 0;
+            this.version = 0;
+
+            // Index of the first row still held in memory.
+            this.offset = 0;
+            this.resident_bytes = 0;
+
+            this.strings = [];
+            this.string_ids = {};
+            this.dirs = [];
+            this.dir_index = {};
+
+            // From offset on, starting at head.
+            this.paths = [];
+            this.reports = [];
+            this.head = 0;
+
+            // Spilled rows until they are written, for good when the
+            // database could not be opened.
+            this.unsaved = {};
+
+            // For all rows.
+            this.status_ids = [];
+            this.action_ids = [];
+            this.module_ids = [];
+            this.dir_ids = [];
+
+            // Field name, then value id, to the increasing indexes of its rows.
+            this.postings = {};
+            for (var field in FIELDS)
+            {
+                if (FIELDS.hasOwnProperty(field))
+                {
+                    this.postings[field] = [];
+                }
+            }
+
+            this.pages = {};
+
+            // Numbers of the pages in `pages`, least recently read first.
+            this.page_order = [];
+        }
+
+        Store.prototype.intern = function (value)
+        {
+            var id = this.string_ids[value];
+
+            if (id === undefined)
+            {
+                id = this.strings.length;
+                this.strings.push(value);
+                this.string_ids[value] = id;
+            }
+
+            return id;
+        };
+
+        Store.prototype.internDir = function (path)
+        {
+            path = path || "";
+
+            var end = Math.max(path.lastIndexOf("/"), path.lastIndexOf("\\"));
+            var dir = (end > 0) ? path.substr(0, end) : path.substr(0, end + 1);
+            var id = this.dir_index[dir];
+
+            if (id === undefined)
+            {
+                id = this.dirs.length;
+                this.dirs.push(dir);
+                this.dir_index[dir] = id;
+            }
+
+            return id;
+        };
+
+        Store.prototype.post = function (field, id)
+        {
+            var postings = this.postings[field];
+
+            if (postings[id] === undefined)
+            {
+                postings[id] = [];
+            }
+            postings[id].push(this.length);
+        };
+
+        Store.prototype.push = function (file)
+        {
+            var status_id = this.intern(file.scan_status);
+            var action_id = this.intern(file.scan_action);
+            var module_id = this.intern(file.module_name);
+            var dir_id = this.internDir(file.path);
+
+            this.paths.push(file.path);
+            this.reports.push(file.module_report);
+            this.status_ids.push(status_id);
+            this.action_ids.push(action_id);
+            this.module_ids.push(module_id);
+            this.dir_ids.push(dir_id);
+
+            this.post("scan_status", status_id);
+            this.post("scan_action", action_id);
+            this.post("module_name", module_id);
+            this.post("path", dir_id);
+
+            this.resident_bytes += ROW_OVERHEAD
+                                 + 2 * ((file.path || "").length + (file.module_report || "").length);
+            this.length++;
+
+            if (this.resident_bytes > this.max_bytes)
+            {
+                this.spill();
+            }
+
+            return this.length;
+        };
+
+        Store.prototype.row = function (index)
+        {
+            var i = index - this.offset + this.head;
+
+            var row = {
+                index: index,
+                key: this.id + ":" + index,
+                path: this.paths[i],
+                scan_status: this.strings[this.status_ids[index]],
+                scan_action: this.strings[this.action_ids[index]],
+                module_name: this.strings[this.module_ids[index]],
+                module_report: this.reports[i]
+            };
+
+            this.decorate(row);
+            return row;
+        };
+
+        // Moves the oldest quarter of the resident rows to IndexedDB.
+        Store.prototype.spill = function ()
+        {
+            var store = this;
+            var count = Math.max(1, Math.floor((store.length - store.offset) / 4));
+            var rows = [];
+            var i;
+
+            if (database_failed)
+            {
+                return;
+            }
+
+            for (i = 0; i < count; i++)
+            {
+                rows.push(store.row(store.offset + i));
+                store.unsaved[rows[i].index] = rows[i];
+                store.resident_bytes -= ROW_OVERHEAD
+                                      + 2 * ((rows[i].path || "").length + (rows[i].module_report || "").length);
+
+                store.paths[store.head + i] = undefined;
+                store.reports[store.head + i] = undefined;
+            }
+
+            store.head += count;
+            store.offset += count;
+
+            // Spilled slots are only dropped once they are half of the
+            // arrays, so that spilling stays linear in the rows spilled.
+            if (store.head * 2 > store.paths.length)
+            {
+                store.paths = store.paths.slice(store.head);
+                store.reports = store.reports.slice(store.head);
+                store.head = 0;
+            }
+
+            openDatabase().then(
+                function (db)
+                {
+                    var transaction = db.transaction(OBJECT_STORE, "readwrite");
+                    var objects = transaction.objectStore(OBJECT_STORE);
+
+                    for (var j = 0; j < rows.length; j++)
+                    {
+                        objects.put(rows[j], [store.id, rows[j].index]);
+                    }
+
+                    transaction.oncomplete = function ()
+                    {
+                        for (var k = 0; k < rows.length; k++)
+                        {
+                            delete store.unsaved[rows[k].index];
+                        }
+                    };
+                },
+                function ()
+                {
+                    console.warn("Detections kept in memory : " + rows.length);
+                }
+            );
+        };
+
+        // Moves page to the most recently read end of page_order.
+        Store.prototype.touchPage = function (page)
+        {
+            if (this.page_order[this.page_order.length - 1] === page)
+            {
+                return;
+            }
+
+            var index = this.page_order.indexOf(page);
+
+            if (index !== -1)
+            {
+                this.page_order.splice(index, 1);
+            }
+            this.page_order.push(page);
+        };
+
+        Store.prototype.loadPage = function (page)
+        {
+            var store = this;
+            var first = page * factory.page_size;
+            var last = Math.min(first + factory.page_size, store.offset) - 1;
+
+            // Forgotten on failure, so that a later read tries again.
+            function failed(error)
+            {
+                console.error("Error when reading spilled detections : " + error);
+                if (store.pages[page] === null)
+                {
+                    delete store.pages[page];
+                }
+            }
+
+            store.pages[page] = null;
+
+            openDatabase().then(function (db)
+            {
+                var range = $window.IDBKeyRange.bound([store.id, first], [store.id, last]);
+                var request = db.transaction(OBJECT_STORE).objectStore(OBJECT_STORE).getAll(range);
+
+                request.onsuccess = function ()
+                {
+                    var rows = {};
+                    for (var i = 0; i < request.result.length; i++)
+                    {
+                        rows[request.result[i].index] = request.result[i];
+                    }
+
+                    store.pages[page] = rows;
+                    store.touchPage(page);
+
+                    // Only keep a few pages around.
+                    while (store.page_order.length > MAX_PAGES)
+                    {
+                        delete store.pages[store.page_order.shift()];
+                    }
+
+                    store.version++;
+                    $rootScope.$applyAsync();
+                };
+                request.onerror = function ()
+                {
+                    failed(request.error);
+                };
+            }, failed);
+        };
+
+        Store.prototype.spilledRow = function (index)
+        {
+            var page = Math.floor(index / factory.page_size);
+            var rows = this.pages[page];
+
+            if (this.unsaved.hasOwnProperty(index))
+            {
+                return this.unsaved[index];
+            }
+
+            // A page read while it was still being spilled is reloaded.
+            if (rows === undefined || (rows && !rows[index]))
+            {
+                this.loadPage(page);
+            }
+
+            if (rows && rows[index])
+            {
+                this.touchPage(page);
+                return rows[index];
+            }
+
+            // Without display fields, so that one-time bindings wait for the page.
+            return { index: index, key: this.id + ":" + index, pending: true };
+        };
+
+        Store.prototype.slice = function (start, end)
+        {
+            var rows = [];
+
+            start = Math.max(0, start || 0);
+            end = Math.min(this.length, end === undefined ? this.length : end);
+
+            for (var i = start; i < end; i++)
+            {
+                rows.push(this.at(i));
+            }
+
+            return rows;
+        };
+
+        Store.prototype.at = function (index)
+        {
+            return index < this.offset ? this.spilledRow(index) : this.row(index);
+        };
+
+        // The distinct values of a field, sorted, for filter choices.
+        Store.prototype.values = function (field)
+        {
+            var store = this;
+            var strings = store[FIELDS[field].strings];
+            var values = [];
+
+            store.postings[field].forEach(function (rows, id)
+            {
+                values.push(strings[id]);
+            });
+
+            return values.sort();
+        };
+
+        Store.prototype.view = function (query)
+        {
+            return new View(this, query);
+        };
+
+        Store.prototype.get = function (index)
+        {
+            var store = this;
+
+            if (index >= store.offset && index < store.length)
+            {
+                return $q.when(store.row(index));
+            }
+
+            if (store.unsaved.hasOwnProperty(index))
+            {
+                return $q.when(store.unsaved[index]);
+            }
+
+            return openDatabase().then(function (db)
+            {
+                var deferred = $q.defer();
+                var request = db.transaction(OBJECT_STORE).objectStore(OBJECT_STORE).get([store.id, index]);
+
+                request.onsuccess = function ()
+                {
+                    deferred.resolve(request.result);
+                };
+                request.onerror = function ()
+                {
+                    deferred.reject(request.error);
+                };
+
+                return deferred.promise;
+            });
+        };
+
+        Store.prototype.dispose = function ()
+        {
+            var store = this;
+
+            store.unsaved = {};
+
+            if (store.offset === 0)
+            {
+                return;
+            }
+
+            openDatabase().then(function (db)
+            {
+                var range = $window.IDBKeyRange.bound([store.id, 0], [store.id, store.offset]);
+                db.transaction(OBJECT_STORE, "readwrite").objectStore(OBJECT_STORE).delete(range);
+            });
+        };
+
+        // query: {prefix, module_name, scan_status, scan_action} to filter
+        // on, `sort` (a field, arrival order when unset), `desc`, and `group`
+        // (a field). Groups come sorted by value, each behind a header row
+        // {group: true, label, count, key}.
+        function View(store, query)
+        {
+            query = query || {};
+
+            this.store = store;
+            this.query = query;
+            this.seen = 0;
+            this.groups = [];
+            this.group_index = {};
+            this.groups_changed = false;
+            this.rows_count = 0;
+            this.store_version = store.version;
+            this.view_version = 0;
+
+            this.prefix = (query.prefix || "").replace(/[\/\\]+$/, "");
+            this.dir_matches = {};
+
+            this.equals = [];
+
+            for (var field in FIELDS)
+            {
+                if (field !== "path" && query[field])
+                {
+                    this.equals.push({ field: field, value: query[field], ids: store[FIELDS[field].ids] });
+                }
+            }
+        }
+
+        // The posting list of the most selective exact filter, an empty one
+        // when a value was never seen, null without exact filters.
+        View.prototype.candidates = function ()
+        {
+            var candidates = null;
+
+            for (var i = 0; i < this.equals.length; i++)
+            {
+                var equal = this.equals[i];
+
+                equal.id = this.store.string_ids[equal.value];
+
+                var postings = (equal.id === undefined) ? [] : (this.store.postings[equal.field][equal.id] || []);
+                if (candidates === null || postings.length < candidates.length)
+                {
+                    candidates = postings;
+                }
+            }
+
+            return candidates;
+        };
+
+        // Position of the first row index >= index in a posting list.
+        function lowerBound(postings, index)
+        {
+            var low = 0, high = postings.length;
+
+            while (low < high)
+            {
+                var middle = (low + high) >> 1;
+                if (postings[middle] < index)
+                {
+                    low = middle + 1;
+                }
+                else
+                {
+                    high = middle;
+                }
+            }
+
+            return low;
+        }
+
+        View.prototype.matchesDir = function (dir_id)
+        {
+            var match = this.dir_matches[dir_id];
+
+            if (match === undefined)
+            {
+                var dir = this.store.dirs[dir_id];
+                var next = dir.charAt(this.prefix.length);
+
+                match = dir.indexOf(this.prefix) === 0
+                     && (dir.length === this.prefix.length || next === "/" || next === "\\" || this.prefix === "");
+                this.dir_matches[dir_id] = match;
+            }
+
+            return match;
+        };
+
+        View.prototype.matches = function (index)
+        {
+            for (var i = 0; i < this.equals.length; i++)
+            {
+                if (this.equals[i].ids[index] !== this.equals[i].id)
+                {
+                    return false;
+                }
+            }
+
+            return this.prefix === "" || this.matchesDir(this.store.dir_ids[index]);
+        };
+
+        // Orders rows by the string of their id for the sort field, then by
+        // arrival so that the order is stable.
+        View.prototype.compare = function ()
+        {
+            var store = this.store;
+            var sign = this.query.desc ? -1 : 1;
+
+            if (!this.query.sort || !FIELDS[this.query.sort])
+            {
+                return function (a, b) { return sign * (a - b); };
+            }
+
+            var ids = store[FIELDS[this.query.sort].ids];
+            var strings = store[FIELDS[this.query.sort].strings];
+
+            return function (a, b)
+            {
+                var x = strings[ids[a]], y = strings[ids[b]];
+
+                if (x === y)
+                {
+                    return sign * (a - b);
+                }
+                return (x < y) ? -sign : sign;
+            };
+        };
+
+        View.prototype.groupFor = function (index)
+        {
+            var field = this.query.group && FIELDS[this.query.group];
+            var id = field ? this.store[field.ids][index] : 0;
+            var group = this.group_index[id];
+
+            if (group === undefined)
+            {
+                group = {
+                    id: id,
+                    label: field ? this.store[field.strings][id] : null,
+                    rows: [],
+                    added: []
+                };
+                this.group_index[id] = group;
+                this.groups.push(group);
+                this.groups_changed = true;
+            }
+
+            return group;
+        };
+
+        // Sorted merge of the rows added to a group since the last refresh.
+        function merge(rows, added, compare)
+        {
+            var merged = new Array(rows.length + added.length);
+            var i = 0, j = 0, k = 0;
+
+            added.sort(compare);
+
+            while (i < rows.length && j < added.length)
+            {
+                merged[k++] = (compare(rows[i], added[j]) <= 0) ? rows[i++] : added[j++];
+            }
+            while (i < rows.length)
+            {
+                merged[k++] = rows[i++];
+            }
+            while (j < added.length)
+            {
+                merged[k++] = added[j++];
+            }
+
+            return merged;
+        }
+
+        View.prototype.refresh = function ()
+        {
+            var store = this.store;
+            var length = store.length;
+            var index, i;
+
+            if (this.seen === length)
+            {
+                if (this.store_version !== store.version)
+                {
+                    // Spilled pages came back.
+                    this.store_version = store.version;
+                    this.view_version++;
+                }
+                return;
+            }
+
+            var candidates = this.candidates();
+
+            if (candidates !== null)
+            {
+                for (i = lowerBound(candidates, this.seen); i < candidates.length; i++)
+                {
+                    index = candidates[i];
+                    if (this.matches(index))
+                    {
+                        this.groupFor(index).added.push(index);
+                    }
+                }
+            }
+            else
+            {
+                for (index = this.seen; index < length; index++)
+                {
+                    if (this.matches(index))
+                    {
+                        this.groupFor(index).added.push(index);
+                    }
+                }
+            }
+
+            var compare = this.compare();
+
+            for (i = 0; i < this.groups.length; i++)
+            {
+                if (this.groups[i].added.length > 0)
+                {
+                    this.rows_count += this.groups[i].added.length;
+                    this.groups[i].rows = merge(this.groups[i].rows, this.groups[i].added, compare);
+                    this.groups[i].added = [];
+                }
+            }
+
+            if (this.groups_changed)
+            {
+                this.groups_changed = false;
+                this.groups.sort(function (a, b)
+                {
+                    return (a.label === b.label) ? 0 : ((a.label < b.label) ? -1 : 1);
+                });
+            }
+
+            this.seen = length;
+            this.store_version = store.version;
+            this.view_version++;
+        };
+
+        Object.defineProperty(View.prototype, "length", {
+            get: function ()
+            {
+                this.refresh();
+                return this.rows_count + (this.query.group ? this.groups.length : 0);
+            }
+        });
+
+        Object.defineProperty(View.prototype, "version", {
+            get: function ()
+            {
+                this.refresh();
+                return this.view_version;
+            }
+        });
+
+        View.prototype.slice = function (start, end)
+        {
+            var rows = [];
+            var grouped = !!this.query.group;
+            var position = 0;
+
+            this.refresh();
+
+            start = Math.max(0, start || 0);
+            end = Math.min(this.length, end === undefined ? this.length : end);
+
+            for (var i = 0; i < this.groups.length && position < end; i++)
+            {
+                var group = this.groups[i];
+                var size = group.rows.length + (grouped ? 1 : 0);
+
+                if (position + size > start)
+                {
+                    var first = Math.max(start - position, 0);
+                    var last = Math.min(end - position, size);
+
+                    for (var j = first; j < last; j++)
+                    {
+                        if (grouped && j === 0)
+                        {
+                            // The count is part of the key: one-time bindings
+                            // of the header are renewed when it grows.
+                            rows.push({
+                                group: true,
+                                label: group.label,
+                                count: group.rows.length,
+                                key: this.store.id + ":group:" + group.id + ":" + group.rows.length
+                            });
+                        }
+                        else
+                        {
+                            rows.push(this.store.at(group.rows[grouped ? j - 1 : j]));
+                        }
+                    }
+                }
+
+                position += size;
+            }
+
+            return rows;
+        };
+
+        View.prototype.get = function (index)
+        {
+            return this.store.get(index);
+        };
+
+        factory.create = function (options)
+        {
+            return new Store(options);
+        };
+
+        return factory;
+    }
+]);
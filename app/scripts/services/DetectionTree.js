@@ -0,0 +1,229 @@
+/***
+
+Copyright (C) 2015, 2016 Teclib'
+
+This file is part of Armadito gui.
+
+Armadito gui is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Armadito gui is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Armadito gui.  If not, see <http://www.gnu.org/licenses/>.
+
+***/
+
+'use strict';
+
+/**
+ * @ngdoc service
+ * @name armaditoApp.DetectionTree
+ * @description
+ * # DetectionTree
+ * Detections of a DetectionStore counted per directory, as the nodes of
+ * a TreeWidget. The trie is built from the directory ids of the store and
+ * only looks at the rows pushed since the last `refresh()`; widget nodes
+ * are only created for the children of expanded folders, so the cost
+ * follows the directories shown, not the files detected.
+ */
+angular.module('armaditoApp')
+    .service('DetectionTree', [function () {
+
+        var factory = {};
+
+        var FOLDER_IMAGE = "/app/images/folder.png";
+        var OPEN_FOLDER_IMAGE = "/app/images/folder-open.png";
+
+        function splitPath(dir)
+        {
+            return dir.split(/[\/\\]/).filter(function (part)
+            {
+                return part !== "";
+            });
+        }
+
+        // Paths as the store filters on them: "/home/user", "C:\Users".
+        function childPath(parent, name, windows)
+        {
+            if (parent.parent === null)
+            {
+                return windows ? name : "/" + name;
+            }
+
+            return parent.path + (windows ? "\\" : "/") + name;
+        }
+
+        // Trie entries stay out of the widget nodes, which only carry the
+        // id of theirs: the widget copes badly with circular references.
+        function Tree(store)
+        {
+            this.store = store;
+            this.entries = [];
+            this.dir_entries = [];
+            this.seen = 0;
+            this.root = this.entry(null, "/", "/");
+            this.nodes = [this.widgetNode(this.root)];
+            this.expand(this.root.node);
+        }
+
+        Tree.prototype.entry = function (parent, name, path)
+        {
+            var entry = {
+                id: this.entries.length,
+                name: name,
+                path: path,
+                parent: parent,
+                count: 0,
+                children: {},
+                child_count: 0,
+                node: null
+            };
+
+            this.entries.push(entry);
+
+            if (parent !== null)
+            {
+                parent.children[name] = entry;
+                parent.child_count++;
+                parent.children_changed = true;
+            }
+
+            return entry;
+        };
+
+        Tree.prototype.dirEntry = function (dir_id)
+        {
+            var entry = this.dir_entries[dir_id];
+
+            if (entry === undefined)
+            {
+                var dir = this.store.dirs[dir_id];
+                var windows = dir.indexOf("/") === -1 && dir.indexOf("\\") !== -1;
+                var parts = splitPath(dir);
+
+                entry = this.root;
+                for (var i = 0; i < parts.length; i++)
+                {
+                    entry = entry.children[parts[i]]
+                         || this.entry(entry, parts[i], childPath(entry, parts[i], windows));
+                }
+                this.dir_entries[dir_id] = entry;
+            }
+
+            return entry;
+        };
+
+        Tree.prototype.label = function (entry)
+        {
+            return entry.name + " (" + entry.count + ")";
+        };
+
+        Tree.prototype.widgetNode = function (entry)
+        {
+            entry.node = {
+                name: this.label(entry),
+                full_path: entry.path,
+                image: FOLDER_IMAGE,
+                type: "folder",
+                entry_id: entry.id,
+                expanded: false,
+                children: []
+            };
+
+            return entry.node;
+        };
+
+        // Children of an expanded folder, the largest first.
+        Tree.prototype.fillChildren = function (entry)
+        {
+            var tree = this;
+            var children = Object.keys(entry.children).map(function (name)
+            {
+                return entry.children[name];
+            });
+
+            children.sort(function (a, b)
+            {
+                return b.count - a.count;
+            });
+
+            entry.node.children = children.map(function (child)
+            {
+                return child.node || tree.widgetNode(child);
+            });
+            entry.children_changed = false;
+        };
+
+        // Folders with a single subfolder open down to the first fork.
+        Tree.prototype.expand = function (node)
+        {
+            var entry = this.entries[node.entry_id];
+
+            while (entry)
+            {
+                entry.node.expanded = true;
+                entry.node.image = OPEN_FOLDER_IMAGE;
+                this.fillChildren(entry);
+
+                if (entry.child_count !== 1)
+                {
+                    break;
+                }
+                entry = entry.children[Object.keys(entry.children)[0]];
+            }
+        };
+
+        Tree.prototype.collapse = function (node)
+        {
+            node.expanded = false;
+            node.image = FOLDER_IMAGE;
+        };
+
+        Tree.prototype.refresh = function ()
+        {
+            var store = this.store;
+            var length = store.length;
+            var touched = {};
+            var id, entry;
+
+            for (var index = this.seen; index < length; index++)
+            {
+                for (entry = this.dirEntry(store.dir_ids[index]); entry !== null; entry = entry.parent)
+                {
+                    entry.count++;
+                    touched[entry.id] = entry;
+                }
+            }
+            this.seen = length;
+
+            for (id in touched)
+            {
+                if (touched.hasOwnProperty(id) && touched[id].node !== null)
+                {
+                    entry = touched[id];
+                    entry.node.name = this.label(entry);
+
+                    if (entry.node.expanded && entry.children_changed)
+                    {
+                        this.expand(entry.node);
+                    }
+                }
+            }
+
+            return this.nodes;
+        };
+
+        factory.create = function (store)
+        {
+            return new Tree(store);
+        };
+
+        return factory;
+    }
+]);
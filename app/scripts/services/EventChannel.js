@@ -0,0 +1,216 @@
+/***
+
+Copyright (C) 2015, 2016 Teclib'
+
+This file is part of Armadito gui.
+
+Armadito gui is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Armadito gui is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Armadito gui.  If not, see <http://www.gnu.org/licenses/>.
+
+***/
+
+'use strict';
+
+/**
+ * @ngdoc service
+ * @name armaditoApp.EventChannel
+ * @description
+ * # EventChannel
+ * Delivers daemon events for a token over one persistent connection, see
+ * EventTransport for the stream, long-poll and resume logic. When Web
+ * Workers are available the connection lives in the EventWorker, which
+ * decodes and folds events before posting them in batches; otherwise, or
+ * when the worker cannot start, it runs on the UI thread.
+ */
+angular.module('armaditoApp')
+    .service('EventChannel', ['$window', function ($window) {
+
+        var factory = {};
+
+        var EventTransport = $window.EventTransport;
+
+        factory.worker_url = "scripts/workers/EventWorker.js";
+        factory.worker_supported = (typeof $window.Worker !== "undefined");
+
+        // Set to false once the daemon refused a stream, so that later
+        // channels go straight to long-polling.
+        factory.streaming_supported = (typeof $window.EventSource !== "undefined");
+
+        // Long-poll batching: the daemon answers as soon as max_events are
+        // queued or max_wait milliseconds have elapsed since the first one.
+        factory.batch = {
+            max_events: 256,
+            max_wait: 100
+        };
+
+        // A long-poll unanswered after request_timeout is sent again, a
+        // stream silent for stall_timeout is reopened; the daemon is asked
+        // for heartbeats often enough that an idle stream is not.
+        factory.request_timeout = 30000;
+        factory.stall_timeout = 30000;
+
+        factory.backoff = {
+            initial: 250,
+            max: 30000
+        };
+
+        factory.parseEvents = EventTransport.parseEvents;
+
+        factory.eventUrl = function (since)
+        {
+            return EventTransport.eventUrl(factory, since);
+        };
+
+        factory.retryDelay = function (attempt)
+        {
+            return EventTransport.retryDelay(factory, attempt);
+        };
+
+        var host_settings = {};
+
+        function settings(base_url, streaming_supported)
+        {
+            return {
+                base_url: base_url || "",
+                streaming_supported: streaming_supported,
+                batch: factory.batch,
+                request_timeout: factory.request_timeout,
+                stall_timeout: factory.stall_timeout,
+                backoff: factory.backoff
+            };
+        }
+
+        // Channels of the local daemon share the factory, so that a refused
+        // stream is remembered; other daemons get their own settings, kept
+        // for the same reason.
+        function channelSettings(base_url)
+        {
+            if (!base_url)
+            {
+                return factory;
+            }
+
+            if (!host_settings.hasOwnProperty(base_url))
+            {
+                host_settings[base_url] = settings(base_url, factory.streaming_supported);
+            }
+            return host_settings[base_url];
+        }
+
+        // Same interface as EventTransport.Channel for its users: close().
+        function WorkerChannel(token, onEvent, onAuthError, onGap, base_url, onState)
+        {
+            var channel = this;
+
+            channel.closed = false;
+            channel.worker = new $window.Worker(factory.worker_url);
+
+            channel.worker.onmessage = function (e)
+            {
+                var message = e.data;
+
+                if (channel.closed)
+                {
+                    return;
+                }
+
+                if (message.events)
+                {
+                    for (var i = 0; i < message.events.length && !channel.closed; i++)
+                    {
+                        onEvent(message.events[i]);
+                    }
+                }
+                else if (message.gap && onGap)
+                {
+                    onGap(message.gap[0], message.gap[1]);
+                }
+                else if (message.connected !== undefined && onState)
+                {
+                    onState(message.connected);
+                }
+                else if (message.streaming_supported === false)
+                {
+                    channelSettings(base_url).streaming_supported = false;
+                }
+                else if (message.auth_error)
+                {
+                    channel.close();
+                    if (onAuthError)
+                    {
+                        onAuthError();
+                    }
+                }
+            };
+
+            // The worker script could not be loaded: run on the UI thread.
+            channel.worker.onerror = function (e)
+            {
+                console.warn("Event worker failed (" + e.message + "), reading events on the UI thread");
+                channel.terminate();
+                factory.worker_supported = false;
+                if (!channel.closed)
+                {
+                    channel.fallback = new EventTransport.Channel(channelSettings(base_url), token, onEvent, onAuthError, onGap, onState);
+                    channel.fallback.connect();
+                }
+            };
+
+            channel.worker.postMessage({ open: { token: token, settings: settings(base_url, channelSettings(base_url).streaming_supported) } });
+        }
+
+        WorkerChannel.prototype.terminate = function ()
+        {
+            if (this.worker !== null)
+            {
+                this.worker.terminate();
+                this.worker = null;
+            }
+        };
+
+        WorkerChannel.prototype.close = function ()
+        {
+            this.closed = true;
+
+            if (this.worker !== null)
+            {
+                this.worker.postMessage({ close: true });
+                this.terminate();
+            }
+
+            if (this.fallback)
+            {
+                this.fallback.close();
+            }
+        };
+
+        // base_url is the origin of another daemon, "" or undefined for
+        // the one serving the UI. onState(connected) follows the losses and
+        // recoveries of the connection.
+        factory.open = function (token, onEvent, onAuthError, onGap, base_url, onState)
+        {
+            if (factory.worker_supported)
+            {
+                return new WorkerChannel(token, onEvent, onAuthError, onGap, base_url, onState);
+            }
+
+            var channel = new EventTransport.Channel(channelSettings(base_url), token, onEvent, onAuthError, onGap, onState);
+
+            channel.connect();
+
+            return channel;
+        };
+
+        return factory;
+    }
+]);
@@ -0,0 +1,613 @@
+/***
+
+Copyright (C) 2015, 2016 Teclib'
+
+This file is part of Armadito gui.
+
+Armadito gui is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Armadito gui is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Armadito gui.  If not, see <http://www.gnu.org/licenses/>.
+
+***/
+
+'use strict';
+
+/**
+ * @ngdoc service
+ * @name armaditoApp.FleetService
+ * @description
+ * # FleetService
+ * Status and scan progress of other daemons, for a console watching many
+ * hosts. Each host gets its own ApiSession (see forHost()); the first
+ * `max_channels` hosts also get an event channel, the others are polled
+ * every `poll_interval` and take over a channel when one is released.
+ * Connecting, polling, resynchronizing and retrying go through a queue of
+ * at most `max_concurrent` requests so that a large fleet does not open
+ * hundreds of requests at once. A host sending more than `max_host_events`
+ * events between two flushes has the rest ignored and is asked for a
+ * snapshot instead; a host whose channel is lost is offline until it
+ * reconnects. Changes are announced by one "FleetChanged" broadcast per
+ * `flush_interval`; rollup() sums them up by module and status.
+ */
+angular.module('armaditoApp')
+    .service('FleetService', ['$rootScope', '$q', '$timeout', '$window', 'ApiSession', 'EventChannel', 'StatusService',
+    function ($rootScope, $q, $timeout, $window, ApiSession, EventChannel, StatusService) {
+
+        var factory = {};
+
+        factory.max_concurrent = 8;
+        factory.max_host_events = 200;
+        factory.flush_interval = 500;
+        factory.max_channels = 32;
+        factory.poll_interval = 30000;
+
+        factory.hosts = [];
+
+        var STORAGE_KEY = "armadito.fleet_hosts";
+
+        var queue = [];
+        var active = 0;
+        var channels = 0;
+        var flush_timer = null;
+        var started = false;
+
+        // Runs task() once fewer than max_concurrent others are running.
+        function limit(task)
+        {
+            var deferred = $q.defer();
+
+            queue.push({ task: task, deferred: deferred });
+            next();
+
+            return deferred.promise;
+        }
+
+        function next()
+        {
+            while (active < factory.max_concurrent && queue.length > 0)
+            {
+                run(queue.shift());
+            }
+        }
+
+        function run(item)
+        {
+            active++;
+            $q.when(item.task()).then(item.deferred.resolve, item.deferred.reject).finally(function ()
+            {
+                active--;
+                next();
+            });
+        }
+
+        function saveHosts()
+        {
+            try {
+                $window.localStorage.setItem(STORAGE_KEY, angular.toJson(factory.hosts.map(function (host)
+                {
+                    return { url: host.url, name: host.name };
+                })));
+            }
+            catch(e)
+            {
+                console.error("Error when saving fleet hosts : " + e);
+            }
+        }
+
+        function loadHosts()
+        {
+            try {
+                return JSON.parse($window.localStorage.getItem(STORAGE_KEY)) || [];
+            }
+            catch(e)
+            {
+                return [];
+            }
+        }
+
+        function changed()
+        {
+            if (flush_timer !== null)
+            {
+                return;
+            }
+
+            flush_timer = $timeout(factory.flush, factory.flush_interval, false);
+        }
+
+        factory.flush = function ()
+        {
+            flush_timer = null;
+
+            for (var i = 0; i < factory.hosts.length; i++)
+            {
+                var host = factory.hosts[i];
+
+                host.events = 0;
+                if (host.resync && host.state === "online")
+                {
+                    host.resync = false;
+                    resync(host);
+                }
+            }
+
+            $rootScope.$applyAsync(function ()
+            {
+                $rootScope.$broadcast("FleetChanged", factory.hosts);
+            });
+        };
+
+        function scanOf(host, scan_id)
+        {
+            if (!host.scans.hasOwnProperty(scan_id))
+            {
+                host.scans[scan_id] = {
+                    scan_id: scan_id,
+                    path: "",
+                    progress: 0,
+                    scanned_count: 0,
+                    suspicious_count: 0,
+                    malware_count: 0,
+                    completed: false
+                };
+            }
+            return host.scans[scan_id];
+        }
+
+        function applyScan(scan, receivedEvent)
+        {
+            var fields = ["path", "progress", "scanned_count", "suspicious_count", "malware_count"];
+
+            for (var i = 0; i < fields.length; i++)
+            {
+                if (receivedEvent[fields[i]] !== undefined)
+                {
+                    scan[fields[i]] = receivedEvent[fields[i]];
+                }
+            }
+        }
+
+        // Detections are not kept: the counters of progress events are
+        // what the fleet view shows.
+        function handleEvent(host, receivedEvent)
+        {
+            var type = receivedEvent.event_type;
+
+            changed();
+
+            if (type === "ChannelStateEvent")
+            {
+                if (!receivedEvent.connected && host.state === "online")
+                {
+                    disconnected(host, { status: 0 });
+                }
+                return;
+            }
+
+            if (type === "StatusEvent")
+            {
+                host.status = StatusService.fromSnapshot(receivedEvent);
+                return;
+            }
+
+            if (++host.events > factory.max_host_events || host.resync)
+            {
+                host.resync = true;
+                return;
+            }
+
+            if (type === "StatusDeltaEvent" && host.status !== null)
+            {
+                StatusService.mergeDelta(host.status, receivedEvent);
+            }
+            else if (type === "OnDemandProgressEvent" && receivedEvent.scan_id !== undefined)
+            {
+                applyScan(scanOf(host, receivedEvent.scan_id), receivedEvent);
+            }
+            else if (type === "OnDemandCompletedEvent" && receivedEvent.scan_id !== undefined)
+            {
+                scanOf(host, receivedEvent.scan_id).completed = true;
+            }
+            else if (type === "EventGapEvent")
+            {
+                host.resync = true;
+            }
+        }
+
+        // Scans the daemon no longer runs are dropped, whether or not
+        // their completion reached us.
+        function reconcile(host, running)
+        {
+            var scans = {};
+
+            for (var i = 0; i < running.length; i++)
+            {
+                var scan = scanOf(host, running[i].scan_id);
+
+                applyScan(scan, running[i]);
+                scans[scan.scan_id] = scan;
+            }
+
+            host.scans = scans;
+        }
+
+        function askForStatus(host)
+        {
+            return host.session.request({
+                method: 'GET',
+                url: '/api/status',
+                params: { watch: 1 }
+            }).then(function ()
+            {
+                return host.session.request({ method: 'GET', url: '/api/scan/running' });
+            }).then(function (response)
+            {
+                var scans = response.data || [];
+
+                reconcile(host, scans);
+                return scans;
+            });
+        }
+
+        // The status snapshot comes back as a StatusEvent on the channel,
+        // running scans are attached so that their events reach it too.
+        function askForState(host)
+        {
+            return askForStatus(host).then(function (scans)
+            {
+                return $q.all(scans.map(function (scan)
+                {
+                    return host.session.request({
+                        method: 'POST',
+                        url: '/api/scan/attach',
+                        data: { scan_id: scan.scan_id },
+                        headers: { "Content-Type": "application/json" }
+                    });
+                }));
+            });
+        }
+
+        // Without a channel the events queued since the last poll, the
+        // StatusEvent of the snapshot among them, are read in one request;
+        // scans are not attached, /api/scan/running has their counters.
+        function pollState(host)
+        {
+            return host.session.request({
+                method: 'GET',
+                url: '/api/status',
+                params: { watch: 1 }
+            }).then(function ()
+            {
+                return host.session.request({
+                    method: 'GET',
+                    url: '/api/event',
+                    params: { max_events: factory.max_host_events, max_wait: 0 }
+                });
+            }).then(function (response)
+            {
+                var receivedEvents = response.data;
+
+                if (!angular.isArray(receivedEvents))
+                {
+                    receivedEvents = receivedEvents ? [receivedEvents] : [];
+                }
+
+                for (var i = 0; i < receivedEvents.length; i++)
+                {
+                    handleEvent(host, receivedEvents[i]);
+                }
+
+                return host.session.request({ method: 'GET', url: '/api/scan/running' });
+            }).then(function (response)
+            {
+                reconcile(host, response.data || []);
+            });
+        }
+
+        function subscribe(host)
+        {
+            if (host.unsubscribe !== null)
+            {
+                return true;
+            }
+
+            if (channels >= factory.max_channels)
+            {
+                return false;
+            }
+
+            channels++;
+            host.unsubscribe = host.session.subscribe(function (receivedEvent)
+            {
+                handleEvent(host, receivedEvent);
+            });
+            return true;
+        }
+
+        function unsubscribe(host)
+        {
+            if (host.unsubscribe !== null)
+            {
+                host.unsubscribe();
+                host.unsubscribe = null;
+                channels--;
+            }
+            host.live = false;
+        }
+
+        // A polled host takes a channel as soon as one is free.
+        function refresh(host)
+        {
+            host.live = subscribe(host);
+            return host.live ? askForState(host) : pollState(host);
+        }
+
+        function online(host)
+        {
+            if (host.removed)
+            {
+                return;
+            }
+
+            host.state = "online";
+            host.attempt = 0;
+            host.error = null;
+            changed();
+
+            if (!host.live)
+            {
+                host.retry = $timeout(function ()
+                {
+                    host.retry = null;
+                    limit(function ()
+                    {
+                        return host.removed ? undefined : refresh(host);
+                    }).then(function ()
+                    {
+                        online(host);
+                    }, function (error)
+                    {
+                        disconnected(host, error);
+                    });
+                }, factory.poll_interval, false);
+            }
+        }
+
+        function resync(host)
+        {
+            return limit(function ()
+            {
+                return host.live ? askForState(host) : pollState(host);
+            }).catch(function (error)
+            {
+                disconnected(host, error);
+            });
+        }
+
+        function disconnected(host, error)
+        {
+            if (host.removed)
+            {
+                return;
+            }
+
+            unsubscribe(host);
+            if (host.retry !== null)
+            {
+                $timeout.cancel(host.retry);
+            }
+
+            host.state = "offline";
+            host.error = error && error.status;
+            changed();
+
+            host.retry = $timeout(function ()
+            {
+                host.retry = null;
+                factory.connect(host);
+            }, EventChannel.retryDelay(host.attempt++), false);
+        }
+
+        factory.connect = function (host)
+        {
+            host.state = "connecting";
+            changed();
+
+            return limit(function ()
+            {
+                if (host.removed)
+                {
+                    return;
+                }
+
+                return host.session.register().then(function ()
+                {
+                    return refresh(host);
+                }).then(function ()
+                {
+                    online(host);
+                });
+            }).catch(function (error)
+            {
+                console.error("Error when connecting to " + host.url + " : " + (error && error.status));
+                disconnected(host, error);
+            });
+        };
+
+        function createHost(url, name)
+        {
+            return {
+                url: url,
+                name: name || url.replace(/^[a-z]+:\/\//, ""),
+                session: ApiSession.forHost(url),
+                status: null,
+                scans: {},
+                state: "offline",
+                error: null,
+                events: 0,
+                resync: false,
+                attempt: 0,
+                retry: null,
+                unsubscribe: null,
+                live: false,
+                removed: false
+            };
+        }
+
+        factory.findHost = function (url)
+        {
+            for (var i = 0; i < factory.hosts.length; i++)
+            {
+                if (factory.hosts[i].url === url)
+                {
+                    return factory.hosts[i];
+                }
+            }
+            return null;
+        };
+
+        factory.addHost = function (url, name)
+        {
+            url = url.replace(/\/+$/, "");
+
+            if (!/^https?:\/\//.test(url))
+            {
+                url = "http://" + url;
+            }
+
+            factory.start();
+
+            var host = factory.findHost(url);
+
+            if (host === null)
+            {
+                host = createHost(url, name);
+                factory.hosts.push(host);
+                saveHosts();
+                factory.connect(host);
+            }
+
+            return host;
+        };
+
+        factory.removeHost = function (host)
+        {
+            var index = factory.hosts.indexOf(host);
+
+            if (index === -1)
+            {
+                return;
+            }
+
+            host.removed = true;
+            if (host.retry !== null)
+            {
+                $timeout.cancel(host.retry);
+            }
+            unsubscribe(host);
+
+            factory.hosts.splice(index, 1);
+            saveHosts();
+            changed();
+        };
+
+        function count(counts, key)
+        {
+            counts[key] = (counts[key] || 0) + 1;
+        }
+
+        // Module rows hold the number of hosts per status, e.g.
+        // {name: "clamav", statuses: {late: 12, "up-to-date": 88}}.
+        factory.rollup = function ()
+        {
+            var rollup = {
+                hosts: factory.hosts.length,
+                states: {},
+                statuses: {},
+                modules: [],
+                scans: { running: 0, scanned_count: 0, suspicious_count: 0, malware_count: 0, progress: 0 }
+            };
+            var modules = {};
+            var i, j;
+
+            for (i = 0; i < factory.hosts.length; i++)
+            {
+                var host = factory.hosts[i];
+
+                count(rollup.states, host.state);
+
+                if (host.status !== null)
+                {
+                    count(rollup.statuses, host.status.global_status);
+
+                    for (j = 0; j < host.status.modules.length; j++)
+                    {
+                        var module = host.status.modules[j];
+
+                        if (!modules.hasOwnProperty(module.name))
+                        {
+                            modules[module.name] = { name: module.name, statuses: {} };
+                            rollup.modules.push(modules[module.name]);
+                        }
+                        count(modules[module.name].statuses, module.mod_status);
+                    }
+                }
+
+                for (var scan_id in host.scans)
+                {
+                    if (host.scans.hasOwnProperty(scan_id) && !host.scans[scan_id].completed)
+                    {
+                        var scan = host.scans[scan_id];
+
+                        rollup.scans.running++;
+                        rollup.scans.scanned_count += scan.scanned_count;
+                        rollup.scans.suspicious_count += scan.suspicious_count;
+                        rollup.scans.malware_count += scan.malware_count;
+                        rollup.scans.progress += scan.progress;
+                    }
+                }
+            }
+
+            if (rollup.scans.running > 0)
+            {
+                rollup.scans.progress = Math.floor(rollup.scans.progress / rollup.scans.running);
+            }
+
+            rollup.modules.sort(function (a, b)
+            {
+                return a.name < b.name ? -1 : (a.name > b.name ? 1 : 0);
+            });
+
+            return rollup;
+        };
+
+        // Saved hosts are connected when a view first asks for the fleet.
+        factory.start = function ()
+        {
+            if (started)
+            {
+                return;
+            }
+
+            started = true;
+            loadHosts().forEach(function (saved)
+            {
+                var host = createHost(saved.url, saved.name);
+
+                factory.hosts.push(host);
+                factory.connect(host);
+            });
+        };
+
+        return factory;
+    }
+]);
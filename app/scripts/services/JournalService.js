@@ -0,0 +1,95 @@
+/***
+
+Copyright (C) 2015, 2016 Teclib'
+
+This file is part of Armadito gui.
+
+Armadito gui is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Armadito gui is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Armadito gui.  If not, see <http://www.gnu.org/licenses/>.
+
+***/
+
+'use strict';
+
+/**
+ * @ngdoc service
+ * @name armaditoApp.JournalService
+ * @description
+ * # JournalService
+ * Reads the daemon journal from /api/journal, one page at a time.
+ * Filtering (date range, type, user) and full-text search on paths are
+ * done by the daemon; the page cursor returned with each page is sent
+ * back to get the next one, so the whole history is never loaded.
+ */
+angular.module('armaditoApp')
+    .service('JournalService', ['ApiSession', 'PagedQuery', function (ApiSession, PagedQuery) {
+
+        var factory = {};
+
+        factory.page_size = 100;
+
+        // Dates from date inputs are sent as seconds, `to` being inclusive
+        // of its whole day.
+        factory.toParams = function (filters, cursor)
+        {
+            var params = { limit: factory.page_size };
+
+            if (cursor)
+            {
+                params.cursor = cursor;
+            }
+            if (filters.q)
+            {
+                params.q = filters.q;
+            }
+            if (filters.type)
+            {
+                params.type = filters.type;
+            }
+            if (filters.user)
+            {
+                params.user = filters.user;
+            }
+            if (filters.from)
+            {
+                params.from = Math.floor(new Date(filters.from).setHours(0, 0, 0, 0) / 1000);
+            }
+            if (filters.to)
+            {
+                params.to = Math.floor(new Date(filters.to).setHours(23, 59, 59, 999) / 1000);
+            }
+
+            return params;
+        };
+
+        factory.fetchPage = function (filters, cursor)
+        {
+            return ApiSession.request({
+                method: 'GET',
+                url: '/api/journal',
+                headers: { "Content-Type": "application/json" },
+                params: factory.toParams(filters, cursor)
+            }).then(function (response)
+            {
+                return PagedQuery.page(response.data);
+            });
+        };
+
+        factory.query = function (filters)
+        {
+            return PagedQuery.create(factory.fetchPage, filters);
+        };
+
+        return factory;
+    }
+]);
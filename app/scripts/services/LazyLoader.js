@@ -0,0 +1,120 @@
+/***
+
+Copyright (C) 2015, 2016 Teclib'
+
+This file is part of Armadito gui.
+
+Armadito gui is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Armadito gui is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Armadito gui.  If not, see <http://www.gnu.org/licenses/>.
+
+***/
+
+'use strict';
+
+/**
+ * @ngdoc service
+ * @name armaditoApp.LazyLoader
+ * @description
+ * # LazyLoader
+ * Loads the scripts of a bundle (see scripts/bundles.json) the first time
+ * a state needs them, then registers what they declared on armaditoApp.
+ * The application is already bootstrapped by then, so the module's queues
+ * are replayed by hand against the providers app.js keeps on the module.
+ * In a build, the manifest is rewritten to point at one minified file
+ * per bundle, which also holds the bundle's templates.
+ */
+angular.module('armaditoApp')
+    .service('LazyLoader', ['$document', '$http', '$injector', '$q', function ($document, $http, $injector, $q) {
+
+        var factory = {};
+
+        factory.manifest_url = 'scripts/bundles.json';
+
+        var module = angular.module('armaditoApp');
+        var invoked = module._invokeQueue.length;
+        var ran = module._runBlocks.length;
+        var manifest = null;
+        var bundles = {};
+
+        function loadManifest()
+        {
+            if (manifest === null)
+            {
+                manifest = $http.get(factory.manifest_url).then(function (response)
+                {
+                    return response.data;
+                });
+            }
+            return manifest;
+        }
+
+        function loadScript(src)
+        {
+            var deferred = $q.defer();
+            var script = $document[0].createElement('script');
+
+            // Downloaded in parallel, executed in document order.
+            script.async = false;
+            script.src = src;
+            script.onload = function ()
+            {
+                deferred.resolve();
+            };
+            script.onerror = function ()
+            {
+                deferred.reject(src);
+            };
+
+            $document[0].body.appendChild(script);
+            return deferred.promise;
+        }
+
+        function register()
+        {
+            var queue = module._invokeQueue;
+
+            for (; invoked < queue.length; invoked++)
+            {
+                var provider = module.providers[queue[invoked][0]];
+                provider[queue[invoked][1]].apply(provider, queue[invoked][2]);
+            }
+
+            // Template caches of built bundles are filled by run blocks.
+            for (; ran < module._runBlocks.length; ran++)
+            {
+                $injector.invoke(module._runBlocks[ran]);
+            }
+        }
+
+        factory.load = function (name)
+        {
+            if (!bundles[name])
+            {
+                bundles[name] = loadManifest().then(function (manifest)
+                {
+                    return $q.all(manifest[name].scripts.map(loadScript));
+                }).then(register, function (error)
+                {
+                    // Let the next transition try again.
+                    delete bundles[name];
+                    console.error("Error when loading bundle " + name + " : " + error);
+                    return $q.reject(error);
+                });
+            }
+
+            return bundles[name];
+        };
+
+        return factory;
+    }
+]);
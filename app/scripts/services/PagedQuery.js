@@ -0,0 +1,159 @@
+/***
+
+Copyright (C) 2015, 2016 Teclib'
+
+This file is part of Armadito gui.
+
+Armadito gui is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Armadito gui is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Armadito gui.  If not, see <http://www.gnu.org/licenses/>.
+
+***/
+
+'use strict';
+
+/**
+ * @ngdoc service
+ * @name armaditoApp.PagedQuery
+ * @description
+ * # PagedQuery
+ * The rows of a cursor-paginated daemon listing loaded so far.
+ * `fetchPage(filters, cursor)` resolves with {entries, next_cursor, total};
+ * the query keeps appending pages on `more()` until next_cursor is null,
+ * and `reload()` starts again for the current filters. Answers to requests
+ * made for older filters are ignored. Every entry gets a `key` unique in
+ * the listing, for ng-repeat to track it by: its id when the daemon gives
+ * one, its timestamp, type and path otherwise.
+ */
+angular.module('armaditoApp')
+    .service('PagedQuery', ['$filter', function ($filter) {
+
+        var factory = {};
+
+        var date = $filter('date');
+
+        // Normalizes a daemon answer {entries, next_cursor, total}. Dates
+        // are formatted once here rather than by a filter on every digest.
+        factory.page = function (data)
+        {
+            var entries = data.entries || [];
+
+            for (var i = 0; i < entries.length; i++)
+            {
+                if (entries[i].timestamp !== undefined)
+                {
+                    entries[i].display_date = date(entries[i].timestamp * 1000, 'dd/MM/yyyy HH:mm');
+                }
+            }
+
+            return {
+                entries: entries,
+                next_cursor: data.next_cursor || null,
+                total: (data.total === undefined) ? null : data.total
+            };
+        };
+
+        function Query(fetchPage, filters)
+        {
+            this.fetchPage = fetchPage;
+            this.filters = filters || {};
+            this.entries = [];
+            this.next_cursor = null;
+            this.total = null;
+            this.loading = false;
+            this.done = false;
+            this.generation = 0;
+            this.keys = {};
+        }
+
+        Query.prototype.keyEntries = function (entries)
+        {
+            for (var i = 0; i < entries.length; i++)
+            {
+                var entry = entries[i];
+                var key = (entry.id !== undefined) ? String(entry.id)
+                        : entry.timestamp + "|" + entry.type + "|" + entry.path;
+
+                // Two entries with the same time, type and path stay apart.
+                if (this.keys.hasOwnProperty(key))
+                {
+                    this.keys[key]++;
+                    key += "|" + this.keys[key];
+                }
+                else
+                {
+                    this.keys[key] = 0;
+                }
+
+                entry.key = key;
+            }
+        };
+
+        Query.prototype.reload = function ()
+        {
+            this.entries = [];
+            this.next_cursor = null;
+            this.total = null;
+            this.done = false;
+            this.generation++;
+            this.loading = false;
+            this.keys = {};
+
+            return this.more();
+        };
+
+        Query.prototype.more = function ()
+        {
+            var query = this;
+            var generation = query.generation;
+
+            if (query.loading || query.done)
+            {
+                return;
+            }
+
+            query.loading = true;
+
+            return query.fetchPage(query.filters, query.next_cursor).then(
+                function (page)
+                {
+                    if (generation !== query.generation)
+                    {
+                        return;
+                    }
+
+                    query.keyEntries(page.entries);
+                    Array.prototype.push.apply(query.entries, page.entries);
+                    query.next_cursor = page.next_cursor;
+                    query.total = page.total;
+                    query.done = (page.next_cursor === null);
+                    query.loading = false;
+                },
+                function (error)
+                {
+                    if (generation === query.generation)
+                    {
+                        query.loading = false;
+                    }
+                    console.error("Error when reading daemon listing : " + error.status);
+                }
+            );
+        };
+
+        factory.create = function (fetchPage, filters)
+        {
+            return new Query(fetchPage, filters);
+        };
+
+        return factory;
+    }
+]);
@@ -0,0 +1,314 @@
+/***
+
+Copyright (C) 2015, 2016 Teclib'
+
+This file is part of Armadito gui.
+
+Armadito gui is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Armadito gui is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Armadito gui.  If not, see <http://www.gnu.org/licenses/>.
+
+***/
+
+'use strict';
+
+/**
+ * @ngdoc service
+ * @name armaditoApp.QuarantineService
+ * @description
+ * # QuarantineService
+ * Lists quarantined files page by page from /api/quarantine and restores
+ * or deletes them in bulk. A bulk operation targets either a list of ids
+ * or every file matching a filter, so that "all" never needs the whole
+ * list on the client. The daemon reports its progress on the event
+ * channel with QuarantineProgressEvent and QuarantineCompletedEvent,
+ * tagged with the op_id sent with the request; each update is broadcast
+ * as "QuarantineOperation" with the operation. When events may have been
+ * lost, or none came for `timeout` milliseconds, the state of running
+ * operations is asked again from GET /api/quarantine/operation; one that
+ * made no progress over a whole `timeout` is ended as failed.
+ * `operation.promise` settles with the operation once it has ended.
+ */
+angular.module('armaditoApp')
+    .service('QuarantineService', ['$rootScope', '$q', '$timeout', 'ApiSession', 'PagedQuery',
+    function ($rootScope, $q, $timeout, ApiSession, PagedQuery) {
+
+        var factory = {};
+
+        factory.page_size = 200;
+        factory.operations = {};
+        factory.unsubscribe = null;
+        factory.timeout = 120000;
+
+        var next_operation = 1;
+
+        factory.fetchPage = function (filters, cursor)
+        {
+            var params = { limit: factory.page_size };
+
+            if (cursor)
+            {
+                params.cursor = cursor;
+            }
+            if (filters.q)
+            {
+                params.q = filters.q;
+            }
+
+            return ApiSession.request({
+                method: 'GET',
+                url: '/api/quarantine',
+                headers: { "Content-Type": "application/json" },
+                params: params
+            }).then(function (response)
+            {
+                return PagedQuery.page(response.data);
+            });
+        };
+
+        factory.query = function (filters)
+        {
+            return PagedQuery.create(factory.fetchPage, filters);
+        };
+
+        function runningOperations()
+        {
+            return Object.keys(factory.operations).length;
+        }
+
+        function broadcast(operation)
+        {
+            $rootScope.$applyAsync(function ()
+            {
+                $rootScope.$broadcast( "QuarantineOperation", operation );
+            });
+        }
+
+        function endOperation(operation, failed)
+        {
+            if (!operation.running)
+            {
+                return;
+            }
+
+            operation.running = false;
+            if (failed !== undefined)
+            {
+                operation.failed = failed;
+            }
+            delete factory.operations[operation.id];
+
+            if (operation.watchdog !== null)
+            {
+                $timeout.cancel(operation.watchdog);
+                operation.watchdog = null;
+            }
+
+            if (runningOperations() === 0)
+            {
+                factory.stopEvents();
+            }
+
+            if (operation.error !== undefined)
+            {
+                operation.deferred.reject(operation);
+            }
+            else
+            {
+                operation.deferred.resolve(operation);
+            }
+            broadcast(operation);
+        }
+
+        // Restarted by every event of the operation.
+        function watch(operation)
+        {
+            if (operation.watchdog !== null)
+            {
+                $timeout.cancel(operation.watchdog);
+            }
+
+            operation.watched_done = operation.done;
+            operation.watchdog = $timeout(function ()
+            {
+                operation.watchdog = null;
+                factory.refresh(operation, true);
+            }, factory.timeout, false);
+        }
+
+        function applyCompletion(operation, completion)
+        {
+            operation.done = completion.done;
+            operation.total = completion.done + (completion.failed || 0);
+            endOperation(operation, completion.failed || 0);
+        }
+
+        // Answers {state: "running" | "completed", done, failed, total}.
+        // `timed_out` when the watchdog asks: an operation that did not
+        // move since the previous watch is given up.
+        factory.refresh = function (operation, timed_out)
+        {
+            var watched_done = operation.watched_done;
+
+            return ApiSession.request({
+                method: 'GET',
+                url: '/api/quarantine/operation',
+                params: { op_id: operation.id }
+            }).then(
+                function (response)
+                {
+                    if (!operation.running)
+                    {
+                        return;
+                    }
+
+                    if (response.data.state !== "running")
+                    {
+                        applyCompletion(operation, response.data);
+                    }
+                    else if (timed_out && response.data.done === watched_done)
+                    {
+                        console.error("Quarantine operation " + operation.id + " made no progress, giving up");
+                        operation.error = "timeout";
+                        endOperation(operation, Math.max(0, (operation.total || 0) - operation.done));
+                    }
+                    else
+                    {
+                        operation.done = response.data.done;
+                        operation.total = response.data.total;
+                        operation.failed = response.data.failed || 0;
+                        watch(operation);
+                        broadcast(operation);
+                    }
+                },
+                function (error)
+                {
+                    // Unknown or unreachable: it cannot be followed anymore.
+                    console.error("Error when asking for the quarantine operation state : " + error.status);
+                    operation.error = error.status;
+                    endOperation(operation, Math.max(0, (operation.total || 0) - operation.done));
+                }
+            );
+        };
+
+        function refreshAll()
+        {
+            angular.forEach(factory.operations, function (operation)
+            {
+                factory.refresh(operation, false);
+            });
+        }
+
+        factory.handleEvent = function (receivedEvent)
+        {
+            // Completions may be among the lost events, or have been sent
+            // while the channel was down.
+            if (receivedEvent.event_type === "EventGapEvent"
+            || (receivedEvent.event_type === "ChannelStateEvent" && receivedEvent.connected))
+            {
+                refreshAll();
+                return;
+            }
+
+            var operation = factory.operations[receivedEvent.op_id];
+
+            if (!operation)
+            {
+                return;
+            }
+
+            if (receivedEvent.event_type === "QuarantineProgressEvent")
+            {
+                operation.done = receivedEvent.done;
+                operation.total = receivedEvent.total;
+                operation.failed = receivedEvent.failed || 0;
+                watch(operation);
+                broadcast(operation);
+            }
+            else if (receivedEvent.event_type === "QuarantineCompletedEvent")
+            {
+                applyCompletion(operation, receivedEvent);
+            }
+        };
+
+        factory.pollEvents = function ()
+        {
+            if (factory.unsubscribe === null)
+            {
+                factory.unsubscribe = ApiSession.subscribe(factory.handleEvent);
+            }
+        };
+
+        factory.stopEvents = function ()
+        {
+            if (factory.unsubscribe !== null)
+            {
+                factory.unsubscribe();
+                factory.unsubscribe = null;
+            }
+        };
+
+        // action is "restore" or "delete". selection is {ids: [...]} or
+        // {filter: {q: ...}}, an empty filter meaning the whole quarantine.
+        factory.apply = function (action, selection)
+        {
+            var operation = {
+                id: Date.now().toString(36) + "-" + next_operation++,
+                action: action,
+                total: selection.ids ? selection.ids.length : null,
+                done: 0,
+                failed: 0,
+                running: true,
+                watchdog: null,
+                watched_done: 0,
+                deferred: $q.defer()
+            };
+
+            var data = { op_id: operation.id };
+            if (selection.ids)
+            {
+                data.ids = selection.ids;
+            }
+            else
+            {
+                data.filter = selection.filter || {};
+            }
+
+            factory.operations[operation.id] = operation;
+
+            // Listen before asking, progress may come right away.
+            factory.pollEvents();
+            watch(operation);
+
+            operation.promise = operation.deferred.promise;
+
+            ApiSession.request({
+                method: 'POST',
+                url: '/api/quarantine/' + action,
+                headers: { "Content-Type": "application/json" },
+                data: data
+            }).catch(
+                function (error)
+                {
+                    // Nothing was done: every file of the selection failed.
+                    console.error("Error when applying " + action + " to quarantine : " + error.status);
+                    operation.error = error.status;
+                    endOperation(operation, operation.total || 0);
+                }
+            );
+
+            return operation;
+        };
+
+        return factory;
+    }
+]);
@@ -0,0 +1,177 @@
+/***
+
+Copyright (C) 2015, 2016 Teclib'
+
+This file is part of Armadito gui.
+
+Armadito gui is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Armadito gui is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Armadito gui.  If not, see <http://www.gnu.org/licenses/>.
+
+***/
+
+'use strict';
+
+/**
+ * @ngdoc service
+ * @name armaditoApp.ReportService
+ * @description
+ * # ReportService
+ * Scan reports kept by the daemon for every completed scan, under the id
+ * of the scan. `open(report_id)` reads one in the ReportReader worker and
+ * fills a ScanData instance batch by batch, so that large reports neither
+ * block the interface nor get loaded as one string. `download(report_id)`
+ * lets the browser save the report to disk as it is received.
+ */
+angular.module('armaditoApp')
+    .service('ReportService', ['$rootScope', '$window', 'ApiSession', 'ScanData', function ($rootScope, $window, ApiSession, ScanData) {
+
+        var factory = {};
+
+        factory.worker_url = "scripts/workers/ReportReader.js";
+        factory.batch_size = 2000;
+
+        factory.reportUrl = function (report_id)
+        {
+            return "/api/report/" + encodeURIComponent(report_id);
+        };
+
+        function Viewer(report_id)
+        {
+            this.report_id = report_id;
+            this.header = null;
+            this.data = ScanData.create();
+            this.loaded = 0;
+            this.done = false;
+            this.error = null;
+            this.worker = null;
+            this.closed = false;
+        }
+
+        Viewer.prototype.handleMessage = function (message)
+        {
+            var i, row;
+
+            if (message.header)
+            {
+                this.header = message.header;
+                this.data.setScanConf(message.header.path, message.header.type);
+                this.data.updateCounters(message.header.scanned_count, message.header.suspicious_count,
+                                         message.header.malware_count, 100);
+            }
+
+            if (message.rows)
+            {
+                for (i = 0; i < message.rows.length; i++)
+                {
+                    row = message.rows[i];
+                    this.data.addScannedFile(row.path, row.scan_status, row.scan_action,
+                                             row.module_name, row.module_report);
+                }
+                this.loaded = message.loaded;
+            }
+
+            if (message.done)
+            {
+                this.done = true;
+                this.data.setCompleted();
+                this.terminate();
+            }
+
+            if (message.error)
+            {
+                console.error("Error when reading report " + this.report_id + " : " + message.error);
+                this.error = message.error;
+                this.terminate();
+            }
+
+            $rootScope.$applyAsync();
+        };
+
+        Viewer.prototype.terminate = function ()
+        {
+            if (this.worker !== null)
+            {
+                this.worker.terminate();
+                this.worker = null;
+            }
+        };
+
+        // Stops reading and frees the detections read so far.
+        Viewer.prototype.close = function ()
+        {
+            this.closed = true;
+            this.terminate();
+            this.data.reset();
+        };
+
+        factory.open = function (report_id)
+        {
+            var viewer = new Viewer(report_id);
+
+            ApiSession.register().then(
+                function (token)
+                {
+                    // Closed while registering: nothing to read any more.
+                    if (viewer.closed)
+                    {
+                        return;
+                    }
+
+                    viewer.worker = new $window.Worker(factory.worker_url);
+                    viewer.worker.onmessage = function (e)
+                    {
+                        viewer.handleMessage(e.data);
+                    };
+                    viewer.worker.onerror = function (e)
+                    {
+                        viewer.handleMessage({ error: e.message });
+                    };
+                    viewer.worker.postMessage({
+                        url: factory.reportUrl(report_id),
+                        token: token,
+                        batch_size: factory.batch_size
+                    });
+                },
+                function (error)
+                {
+                    if (viewer.closed)
+                    {
+                        return;
+                    }
+
+                    viewer.handleMessage({ error: "HTTP status " + error.status });
+                }
+            );
+
+            return viewer;
+        };
+
+        // A link rather than $http, so that the report goes straight to disk.
+        // Like EventSource, a link cannot set headers: the token goes in the query.
+        factory.download = function (report_id)
+        {
+            return ApiSession.register().then(function (token)
+            {
+                var link = $window.document.createElement("a");
+
+                link.href = factory.reportUrl(report_id) + "?download=1&token=" + encodeURIComponent(token);
+                link.download = "armadito-scan-" + report_id + ".ndjson";
+                $window.document.body.appendChild(link);
+                link.click();
+                $window.document.body.removeChild(link);
+            });
+        };
+
+        return factory;
+    }
+]);
@@ -29,35 +29,69 @@ along with Armadito gui.  If not, see <http://www.gnu.org/licenses/>.
  * Controller of the armaditoApp
  */
 angular.module('armaditoApp')
-  .factory('ScanData',
-    function ()
+  .factory('ScanData', ['$filter', 'DetectionStore',
+    function ($filter, DetectionStore)
     {
-        return {
-            data:
-            {
+        var strLimit = $filter('strLimit');
+
+        var STATUS_CLASSES = {
+            malware: "redCircle",
+            suspicious: "orangeCircle"
+        };
+
+        // Display fields are computed once per row read from the store,
+        // instead of by filters in the view on every digest.
+        function decorate(row)
+        {
+            var report = row.module_report || "";
+
+            row.status_class = STATUS_CLASSES[row.scan_status] || "";
+            row.display_path = strLimit(row.path, 10, 40) || "";
+            row.display_report = (report.length > 30) ? report.substr(0, 30) + "..." : report;
+        }
+
+        function newData()
+        {
+            return {
                 suspicious_count: 0,
                 scanned_count: 0,
                 malware_count: 0,
-                scan_progress: 0,
+                skipped_count: 0,
                 progress: 0,
-                canceled: 0,
+                canceled : 0,
+                completed : 0,
                 path_to_scan: "",
+                display_path: "",
                 displayed_file: "",
+                display_file: "",
                 type: "scan_view.Choose_scan_type",
-                files: []
-            },
+                files: DetectionStore.create({ decorate: decorate })
+            };
+        }
+
+        // The injected ScanData holds the totals of all scan jobs,
+        // every job gets its own instance from ScanData.create().
+        function ScanData()
+        {
+            this.data = newData();
+        }
 
-            updateCounters: function (scanned_count, suspicious_count, malware_count, progress )
+        ScanData.prototype =
+        {
+            updateCounters: function (scanned_count, suspicious_count, malware_count, progress, skipped_count )
             {
                 this.data.suspicious_count = suspicious_count;
                 this.data.scanned_count = scanned_count;
                 this.data.malware_count = malware_count;
                 this.data.progress = progress;
+                this.data.skipped_count = skipped_count || 0;
             },
 
-            setDisplayedFile: function (_displayed_file)
+            // display_file may come already truncated from the EventWorker.
+            setDisplayedFile: function (_displayed_file, display_file)
             {
                 this.data.displayed_file = _displayed_file;
+                this.data.display_file = (display_file !== undefined) ? display_file : (strLimit(_displayed_file, 24, 23) || "");
             },
 
             addScannedFile: function (file_path, file_scan_status, file_scan_action, file_mod_name, file_mod_report)
@@ -73,9 +107,15 @@ angular.module('armaditoApp')
                 this.data.files.push(file);
             },
 
+            getScannedFile: function (index)
+            {
+                return this.data.files.get(index);
+            },
+
             setScanConf: function (path_to_scan, type)
             {
                 this.data.path_to_scan =  path_to_scan;
+                this.data.display_path = strLimit(path_to_scan, 5, 15) || "";
                 this.data.type = type;
             },
 
@@ -84,21 +124,50 @@ angular.module('armaditoApp')
                 this.data.canceled = 1;
             },
 
-            reset: function ()
+            // A canceled scan keeps its partial progress.
+            setCompleted: function ()
             {
-                this.data =
+                this.data.completed = 1;
+                if (!this.data.canceled)
                 {
-                    suspicious_count: 0,
-                    scanned_count: 0,
-                    malware_count: 0,
-                    progress: 0,
-                    canceled : 0,
-                    path_to_scan: "",
-                    displayed_file: "",
-                    type: "scan_view.Choose_scan_type",
-                    files: []
-                };
+                    this.data.progress = 100;
+                }
+            },
+
+            // Sums the counters of the given job instances.
+            aggregate: function (instances)
+            {
+                var scanned_count = 0, suspicious_count = 0, malware_count = 0, progress = 0, skipped_count = 0;
+
+                for (var i = 0; i < instances.length; i++)
+                {
+                    scanned_count += instances[i].data.scanned_count;
+                    suspicious_count += instances[i].data.suspicious_count;
+                    malware_count += instances[i].data.malware_count;
+                    progress += instances[i].data.progress;
+                    skipped_count += instances[i].data.skipped_count;
+                }
+
+                if (instances.length > 0)
+                {
+                    progress = Math.floor(progress / instances.length);
+                }
+
+                this.updateCounters(scanned_count, suspicious_count, malware_count, progress, skipped_count);
+            },
+
+            reset: function ()
+            {
+                this.data.files.dispose();
+                this.data = newData();
+            },
+
+            create: function ()
+            {
+                return new ScanData();
             }
         };
+
+        return new ScanData();
     }
-);
+]);
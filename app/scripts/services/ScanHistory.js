@@ -0,0 +1,77 @@
+/***
+
+Copyright (C) 2015, 2016 Teclib'
+
+This file is part of Armadito gui.
+
+Armadito gui is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Armadito gui is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Armadito gui.  If not, see <http://www.gnu.org/licenses/>.
+
+***/
+
+'use strict';
+
+/**
+ * @ngdoc service
+ * @name armaditoApp.ScanHistory
+ * @description
+ * # ScanHistory
+ * Remembers, per scanned path, when the last scan that ran to completion
+ * started and the fingerprint-cache token the daemon returned with it.
+ * Incremental scans send them so that unchanged files are skipped.
+ */
+angular.module('armaditoApp')
+    .service('ScanHistory', ['$window', function ($window) {
+
+        var factory = {};
+
+        var STORAGE_KEY = "armadito.last_clean_scans";
+
+        function load()
+        {
+            try {
+                return JSON.parse($window.localStorage.getItem(STORAGE_KEY)) || {};
+            }
+            catch(e)
+            {
+                return {};
+            }
+        }
+
+        factory.lastCleanScan = function (path)
+        {
+            return load()[path] || null;
+        };
+
+        // started is in milliseconds, the daemon expects seconds.
+        factory.recordCleanScan = function (path, started, fingerprint)
+        {
+            var scans = load();
+
+            scans[path] = {
+                since: Math.floor(started / 1000),
+                fingerprint: fingerprint || null
+            };
+
+            try {
+                $window.localStorage.setItem(STORAGE_KEY, JSON.stringify(scans));
+            }
+            catch(e)
+            {
+                console.error("Error when saving scan history : " + e);
+            }
+        };
+
+        return factory;
+    }
+]);
@@ -0,0 +1,160 @@
+/***
+
+Copyright (C) 2015, 2016 Teclib'
+
+This file is part of Armadito gui.
+
+Armadito gui is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Armadito gui is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Armadito gui.  If not, see <http://www.gnu.org/licenses/>.
+
+***/
+
+'use strict';
+
+/**
+ * @ngdoc service
+ * @name armaditoApp.ScanMetrics
+ * @description
+ * # ScanMetrics
+ * Throughput and latency figures of the running scans, fed by
+ * ScanUpdateQueue: every event goes through recordEvent() and every flush
+ * through recordFlush(). Rates and ETA are computed over the last
+ * `window` milliseconds of samples.
+ */
+angular.module('armaditoApp')
+    .service('ScanMetrics', [function () {
+
+        var factory = {};
+
+        factory.window = 10000;
+
+        var samples, bytes_by_job, modules, current_file, file_since;
+        var events_since_flush, event_lag, last_flush;
+
+        factory.reset = function ()
+        {
+            samples = [];
+            bytes_by_job = {};
+            modules = {};
+            current_file = "";
+            file_since = Date.now();
+            events_since_flush = 0;
+            event_lag = null;
+            last_flush = { events: 0, digest_ms: 0 };
+        };
+
+        factory.recordEvent = function (receivedEvent, job)
+        {
+            var now = Date.now();
+
+            // Progress events folded by the EventWorker count for all of them.
+            events_since_flush += receivedEvent.coalesced || 1;
+
+            // Daemon timestamps are in seconds, the lag is a moving average.
+            if (receivedEvent.timestamp)
+            {
+                var lag = Math.max(0, now - receivedEvent.timestamp * 1000);
+                event_lag = (event_lag === null) ? lag : 0.9 * event_lag + 0.1 * lag;
+            }
+
+            if (receivedEvent.event_type === "OnDemandProgressEvent")
+            {
+                if (receivedEvent.scanned_bytes !== undefined)
+                {
+                    bytes_by_job[job.id] = receivedEvent.scanned_bytes;
+                }
+
+                if (receivedEvent.path && receivedEvent.path !== current_file)
+                {
+                    current_file = receivedEvent.path;
+                    file_since = now;
+                }
+            }
+            else if (receivedEvent.event_type === "DetectionEvent" && receivedEvent.module_name)
+            {
+                modules[receivedEvent.module_name] = (modules[receivedEvent.module_name] || 0) + 1;
+            }
+        };
+
+        // scan_data holds the totals of all jobs after the flush.
+        factory.recordFlush = function (scan_data, digest_ms)
+        {
+            var now = Date.now();
+            var bytes = 0;
+
+            for (var id in bytes_by_job)
+            {
+                if (bytes_by_job.hasOwnProperty(id))
+                {
+                    bytes += bytes_by_job[id];
+                }
+            }
+
+            samples.push({
+                time: now,
+                scanned: scan_data.scanned_count,
+                bytes: bytes,
+                progress: scan_data.progress
+            });
+
+            while (samples.length > 2 && now - samples[0].time > factory.window)
+            {
+                samples.shift();
+            }
+
+            last_flush = { events: events_since_flush, digest_ms: digest_ms };
+            events_since_flush = 0;
+        };
+
+        factory.snapshot = function ()
+        {
+            var now = Date.now();
+            var snapshot = {
+                files_per_s: 0,
+                mb_per_s: 0,
+                eta_s: null,
+                current_file_s: Math.floor((now - file_since) / 1000),
+                modules: modules,
+                event_lag_ms: (event_lag === null) ? null : Math.round(event_lag),
+                events_per_digest: last_flush.events,
+                digest_ms: Math.round(last_flush.digest_ms * 10) / 10
+            };
+
+            if (samples.length >= 2)
+            {
+                var first = samples[0];
+                var last = samples[samples.length - 1];
+                var seconds = (last.time - first.time) / 1000;
+
+                if (seconds > 0)
+                {
+                    var progress_rate = (last.progress - first.progress) / seconds;
+
+                    snapshot.files_per_s = Math.round((last.scanned - first.scanned) / seconds);
+                    snapshot.mb_per_s = Math.round((last.bytes - first.bytes) / seconds / 104857.6) / 10;
+
+                    if (progress_rate > 0)
+                    {
+                        snapshot.eta_s = Math.round((100 - last.progress) / progress_rate);
+                    }
+                }
+            }
+
+            return snapshot;
+        };
+
+        factory.reset();
+
+        return factory;
+    }
+]);
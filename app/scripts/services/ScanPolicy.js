@@ -0,0 +1,197 @@
+/***
+
+Copyright (C) 2015, 2016 Teclib'
+
+This file is part of Armadito gui.
+
+Armadito gui is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Armadito gui is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Armadito gui.  If not, see <http://www.gnu.org/licenses/>.
+
+***/
+
+'use strict';
+
+/**
+ * @ngdoc service
+ * @name armaditoApp.ScanPolicy
+ * @description
+ * # ScanPolicy
+ * The scan policy of the daemon, read from and sent to /api/scan/policy:
+ * how hard scans may push the machine (CPU and IO priority, a maximum
+ * rate, pausing on battery or above a load average) and the scans it
+ * starts by itself. A scheduled scan runs at `time` on each of its `days`
+ * (0 is Sunday) with the content of a saved scan profile. The General tab
+ * adds how often signatures are updated, in hours, and where quarantined
+ * files go; empty values leave the daemon's own.
+ */
+angular.module('armaditoApp')
+    .service('ScanPolicy', ['$q', 'ApiSession', 'ScanProfiles', function ($q, ApiSession, ScanProfiles) {
+
+        var factory = {};
+
+        factory.priorities = ["normal", "low", "idle"];
+
+        function defaults()
+        {
+            return {
+                throttle: {
+                    cpu_priority: "normal",
+                    io_priority: "normal",
+                    max_files_per_second: 0,
+                    pause_on_battery: false,
+                    pause_load_above: null
+                },
+                update_interval: null,
+                quarantine_path: "",
+                schedules: []
+            };
+        }
+
+        factory.policy = defaults();
+
+        // Missing fields of an older daemon get their default value.
+        factory.fromResponse = function (data)
+        {
+            var policy = defaults();
+
+            angular.extend(policy.throttle, (data && data.throttle) || {});
+            if (data && data.update_interval)
+            {
+                policy.update_interval = data.update_interval;
+            }
+            if (data && data.quarantine_path)
+            {
+                policy.quarantine_path = data.quarantine_path;
+            }
+            policy.schedules = ((data && data.schedules) || []).map(function (schedule)
+            {
+                return {
+                    id: schedule.id,
+                    name: schedule.name || "",
+                    path: schedule.path || "/",
+                    days: schedule.days || [],
+                    time: schedule.time || "12:00",
+                    profile_name: schedule.profile_name || "",
+                    enabled: schedule.enabled !== false
+                };
+            });
+
+            return policy;
+        };
+
+        // 0 files per second and an empty load mean no limit. Profiles are
+        // local to this interface: their content goes with the schedule.
+        factory.toRequest = function (policy)
+        {
+            var throttle = policy.throttle;
+            var load = parseFloat(throttle.pause_load_above);
+            var update_interval = parseInt(policy.update_interval, 10);
+
+            return {
+                throttle: {
+                    cpu_priority: throttle.cpu_priority,
+                    io_priority: throttle.io_priority,
+                    max_files_per_second: (throttle.max_files_per_second > 0) ? Math.floor(throttle.max_files_per_second) : null,
+                    pause_on_battery: !!throttle.pause_on_battery,
+                    pause_load_above: (load > 0) ? load : null
+                },
+                update_interval: (update_interval > 0) ? update_interval : null,
+                quarantine_path: policy.quarantine_path || null,
+                schedules: policy.schedules.map(function (schedule)
+                {
+                    var profile = schedule.profile_name ? ScanProfiles.find(schedule.profile_name) : null;
+
+                    return {
+                        id: schedule.id,
+                        name: schedule.name,
+                        path: schedule.path,
+                        days: schedule.days.slice().sort(),
+                        time: schedule.time,
+                        enabled: schedule.enabled,
+                        profile_name: schedule.profile_name || null,
+                        profile: profile ? ScanProfiles.toRequest(profile) : null
+                    };
+                })
+            };
+        };
+
+        // The next time a schedule runs after now, null when it never does.
+        factory.nextRun = function (schedule, now)
+        {
+            var parts = (schedule.time || "").split(":");
+            var hours = parseInt(parts[0], 10), minutes = parseInt(parts[1], 10);
+
+            if (!schedule.enabled || !schedule.days.length || isNaN(hours) || isNaN(minutes))
+            {
+                return null;
+            }
+
+            now = now || new Date();
+
+            for (var offset = 0; offset <= 7; offset++)
+            {
+                var run = new Date(now.getFullYear(), now.getMonth(), now.getDate() + offset, hours, minutes);
+
+                if (run > now && schedule.days.indexOf(run.getDay()) !== -1)
+                {
+                    return run;
+                }
+            }
+
+            return null;
+        };
+
+        factory.load = function ()
+        {
+            return ApiSession.request({
+                method: 'GET',
+                url: '/api/scan/policy',
+                headers: { "Content-Type": "application/json" }
+            }).then(
+                function (response)
+                {
+                    factory.policy = factory.fromResponse(response.data);
+                    return factory.policy;
+                },
+                function (error)
+                {
+                    console.error("Error when reading the scan policy : " + error.status);
+                    return $q.reject(error);
+                }
+            );
+        };
+
+        factory.save = function (policy)
+        {
+            return ApiSession.request({
+                method: 'POST',
+                url: '/api/scan/policy',
+                headers: { "Content-Type": "application/json" },
+                data: factory.toRequest(policy)
+            }).then(
+                function ()
+                {
+                    factory.policy = angular.copy(policy);
+                    return factory.policy;
+                },
+                function (error)
+                {
+                    console.error("Error when saving the scan policy : " + error.status);
+                    return $q.reject(error);
+                }
+            );
+        };
+
+        return factory;
+    }
+]);
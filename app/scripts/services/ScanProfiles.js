@@ -0,0 +1,137 @@
+/***
+
+Copyright (C) 2015, 2016 Teclib'
+
+This file is part of Armadito gui.
+
+Armadito gui is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Armadito gui is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Armadito gui.  If not, see <http://www.gnu.org/licenses/>.
+
+***/
+
+'use strict';
+
+/**
+ * @ngdoc service
+ * @name armaditoApp.ScanProfiles
+ * @description
+ * # ScanProfiles
+ * Saved scan profiles: heuristic mode, archive scanning and exclusions.
+ * toRequest() turns the options of the custom scan modal into the
+ * `profile` object sent with /api/scan. Exclusions are globs when they
+ * contain a wildcard and path prefixes otherwise; the daemon applies
+ * them before opening any file.
+ */
+angular.module('armaditoApp')
+    .service('ScanProfiles', ['$window', function ($window) {
+
+        var factory = {};
+
+        var STORAGE_KEY = "armadito.scan_profiles";
+
+        factory.profiles = [];
+
+        function save()
+        {
+            try {
+                $window.localStorage.setItem(STORAGE_KEY, angular.toJson(factory.profiles));
+            }
+            catch(e)
+            {
+                console.error("Error when saving scan profiles : " + e);
+            }
+        }
+
+        factory.exclusion = function (pattern)
+        {
+            return {
+                type: /[*?\[]/.test(pattern) ? "glob" : "prefix",
+                pattern: pattern
+            };
+        };
+
+        // optionScan is the object built by CustomScanController.
+        factory.toRequest = function (optionScan)
+        {
+            return {
+                heuristic: !!optionScan.heuristicMode,
+                scan_archive: !!optionScan.scanArchive,
+                exclusions: (optionScan.exclusions || []).map(factory.exclusion)
+            };
+        };
+
+        factory.find = function (name)
+        {
+            for (var i = 0; i < factory.profiles.length; i++)
+            {
+                if (factory.profiles[i].name === name)
+                {
+                    return factory.profiles[i];
+                }
+            }
+            return null;
+        };
+
+        // previous_name, when given, is the name the profile was saved
+        // under: it is renamed rather than copied, replacing any profile
+        // already saved under the new name.
+        factory.saveProfile = function (name, optionScan, previous_name)
+        {
+            var profile = factory.find(name);
+            var previous = (previous_name && previous_name !== name) ? factory.find(previous_name) : null;
+
+            if (previous !== null)
+            {
+                if (profile !== null)
+                {
+                    factory.profiles.splice(factory.profiles.indexOf(profile), 1);
+                }
+                profile = previous;
+                profile.name = name;
+            }
+            else if (profile === null)
+            {
+                profile = { name: name };
+                factory.profiles.push(profile);
+            }
+
+            profile.heuristicMode = !!optionScan.heuristicMode;
+            profile.scanArchive = !!optionScan.scanArchive;
+            profile.exclusions = (optionScan.exclusions || []).slice();
+
+            save();
+            return profile;
+        };
+
+        factory.removeProfile = function (name)
+        {
+            var profile = factory.find(name);
+
+            if (profile !== null)
+            {
+                factory.profiles.splice(factory.profiles.indexOf(profile), 1);
+                save();
+            }
+        };
+
+        try {
+            factory.profiles = JSON.parse($window.localStorage.getItem(STORAGE_KEY)) || [];
+        }
+        catch(e)
+        {
+            factory.profiles = [];
+        }
+
+        return factory;
+    }
+]);
@@ -6,108 +6,564 @@
  * @description
  * # ScanService
  * Service in the armaditoApp.
+ * Several scan jobs may run at once. Each job has its own id, sent with
+ * /api/scan and echoed by the daemon as `scan_id` in every event, and its
+ * own ScanData instance. Events are broadcast with the job they belong to.
+ * Jobs outlive the interface: the daemon checkpoints them, the ids of the
+ * unfinished ones are saved, and reattach() finds them again on startup,
+ * replaying their detections from the daemon. Interrupted jobs can be
+ * resumed from their checkpoint, and detections lost by the event
+ * channel are replayed from the last sequence number seen.
  */
 angular.module('armaditoApp')
-	.service('ScanService', ['$rootScope', function ($rootScope) {
+	.service('ScanService', ['$rootScope', '$timeout', '$window', 'ApiSession', 'ScanData', 'ScanHistory', 'UiTrace',
+    function ($rootScope, $timeout, $window, ApiSession, ScanData, ScanHistory, UiTrace) {
 
 	  	var factory = {};
 
-        function parseJson(json)
+        factory.unsubscribe = null;
+        factory.jobs = [];
+
+        // How long a canceled job may keep sending events before its
+        // channel is closed anyway.
+        factory.cancel_drain_timeout = 5000;
+
+        factory.replay_page_size = 1000;
+
+        // Delays between attempts to reattach to a job of a previous
+        // session while the daemon does not answer.
+        factory.attach_retry = {
+            initial: 1000,
+            max: 30000
+        };
+
+        var STORAGE_KEY = "armadito.scan_jobs";
+        var next_job = 1;
+
+        function loadSavedJobs()
+        {
+            try {
+                return JSON.parse($window.localStorage.getItem(STORAGE_KEY)) || [];
+            }
+            catch(e)
+            {
+                return [];
+            }
+        }
+
+        // Only unfinished jobs are worth finding again.
+        function saveJobs()
         {
-            var parsed;
+            var saved = factory.jobs.filter(function (job)
+            {
+                return job.running || job.interrupted;
+            }).map(function (job)
+            {
+                return {
+                    id: job.id,
+                    path: job.path,
+                    type: job.data.data.type,
+                    options: job.options,
+                    started: job.started
+                };
+            });
+
             try {
-                parsed = JSON.parse(json);
+                $window.localStorage.setItem(STORAGE_KEY, angular.toJson(saved));
             }
             catch(e)
             {
-                console.error("Error when parsing JSON : "+e);
+                console.error("Error when saving scan jobs : " + e);
+            }
+        }
+
+        function changed(job)
+        {
+            $rootScope.$broadcast( "ScanJobChanged", job );
+        }
+
+        factory.runningJobs = function ()
+        {
+            return factory.jobs.filter(function (job)
+            {
+                return job.running;
+            });
+        };
+
+        factory.findJob = function (receivedEvent)
+        {
+            var i;
+
+            if (receivedEvent.scan_id !== undefined)
+            {
+                for (i = 0; i < factory.jobs.length; i++)
+                {
+                    if (factory.jobs[i].id === receivedEvent.scan_id)
+                    {
+                        return factory.jobs[i];
+                    }
+                }
+                return null;
             }
-            return parsed;
+
+            // Daemons that do not tag their events can only run one job.
+            var running = factory.runningJobs();
+            return running.length === 1 ? running[0] : null;
         };
 
         factory.handleEvent = function (receivedEvent)
         {
+            var started = UiTrace.begin("handleEvent");
+
+            UiTrace.count("events_received", receivedEvent.coalesced || 1);
+            applyEvent(receivedEvent);
+            UiTrace.end("handleEvent", started);
+        };
+
+        // Only scans that found nothing may serve as the base of an
+        // incremental one. Counters may still wait in ScanUpdateQueue, so
+        // the completion's, the job's and the detections seen all count.
+        function hasDetections(job, receivedEvent)
+        {
+            var data = job.data.data;
+
+            return job.detections > 0
+                || (receivedEvent.malware_count || 0) + (receivedEvent.suspicious_count || 0) > 0
+                || (data.malware_count || 0) + (data.suspicious_count || 0) > 0;
+        }
+
+        function applyEvent(receivedEvent)
+        {
+            if (receivedEvent.event_type === "EventGapEvent")
+            {
+                factory.handleGap(receivedEvent);
+                return;
+            }
+
+            var job = factory.findJob(receivedEvent);
+
+            if (job === null)
+            {
+                UiTrace.count("events_dropped");
+                return;
+            }
+
+            if (receivedEvent.event_type === "DetectionEvent" && typeof receivedEvent.seq === "number")
+            {
+                // Already replayed, or to be applied after the replay.
+                if (job.detection_seq !== null && receivedEvent.seq <= job.detection_seq)
+                {
+                    UiTrace.count("events_duplicate");
+                    return;
+                }
+                if (job.replaying)
+                {
+                    job.buffer.push(receivedEvent);
+                    return;
+                }
+                job.detection_seq = receivedEvent.seq;
+            }
+
+            if (receivedEvent.event_type === "DetectionEvent"
+            && (receivedEvent.scan_status === 'malware' || receivedEvent.scan_status === 'suspicious'))
+            {
+                job.detections++;
+            }
+
             if (receivedEvent.event_type === "OnDemandProgressEvent")
             {
-                $rootScope.$broadcast( "OnDemandProgressEvent", receivedEvent );
-                factory.pollEvents();
+                $rootScope.$broadcast( "OnDemandProgressEvent", receivedEvent, job );
             }
             else if (receivedEvent.event_type === "DetectionEvent")
             {
-                $rootScope.$broadcast( "DetectionEvent", receivedEvent );
-                factory.pollEvents();
+                $rootScope.$broadcast( "DetectionEvent", receivedEvent, job );
             }
             else if (receivedEvent.event_type === "OnDemandCompletedEvent")
             {
-                factory.apiUnregister();
-                $rootScope.$broadcast( "OnDemandCompletedEvent", receivedEvent );
+                if (!job.data.data.canceled && !receivedEvent.canceled && !hasDetections(job, receivedEvent))
+                {
+                    ScanHistory.recordCleanScan(job.path, job.started, receivedEvent.fingerprint);
+                }
+                factory.endJob(job);
+                $rootScope.$broadcast( "OnDemandCompletedEvent", receivedEvent, job );
+            }
+            else if (receivedEvent.event_type === "OnDemandInterruptedEvent")
+            {
+                // The daemon stopped, the job waits at its checkpoint.
+                job.interrupted = true;
+                factory.endJob(job);
+                changed(job);
+            }
+        }
+
+        // Lost events are not tagged: every running job may have missed
+        // some. Progress events carry absolute values and catch up by
+        // themselves, only detections are gone for good.
+        factory.handleGap = function (receivedEvent)
+        {
+            var missed = receivedEvent.last_seq - receivedEvent.first_seq + 1;
+            var running = factory.runningJobs();
+
+            UiTrace.count("events_missed", missed);
+
+            for (var i = 0; i < running.length; i++)
+            {
+                running[i].missed_events = (running[i].missed_events || 0) + missed;
+                factory.replay(running[i]);
             }
         };
 
-        factory.pollEvents = function ()
+        factory.endJob = function (job)
         {
-	      	factory.xmlhttp.onreadystatechange = function ()
-	      	{
-                if (factory.xmlhttp.readyState == 4 && factory.xmlhttp.status == 200)
-                {
-	                var jobj = parseJson(factory.xmlhttp.responseText);
-	                factory.handleEvent(jobj);
-                 }
-	      	};
+            job.running = false;
+            saveJobs();
+
+            if (job.drain_timer)
+            {
+                $timeout.cancel(job.drain_timer);
+                job.drain_timer = null;
+            }
 
-	      	factory.xmlhttp.open("GET", "/api/event", true);
-	      	factory.xmlhttp.setRequestHeader("X-Armadito-Token", factory.token);
-	      	factory.xmlhttp.send(null);
+            if (factory.runningJobs().length === 0)
+            {
+                factory.stopEvents();
+            }
+        };
+
+        factory.pollEvents = function ()
+        {
+            if (factory.unsubscribe === null)
+            {
+                factory.unsubscribe = ApiSession.subscribe(factory.handleEvent);
+            }
 	  	};
 
-	  	factory.AskForNewScan = function ()
+        factory.stopEvents = function ()
+        {
+            if (factory.unsubscribe !== null)
+            {
+                factory.unsubscribe();
+                factory.unsubscribe = null;
+            }
+        };
+
+	  	factory.AskForNewScan = function (job)
 	  	{
-            var data = {path: factory.path_to_scan};
+            var data = angular.extend({}, job.options, {path: job.path, scan_id: job.id, checkpoint: true});
 
-            factory.xmlhttp.onreadystatechange = function ()
-            {
-                if (factory.xmlhttp.readyState == 4 && factory.xmlhttp.status == 200)
+            return ApiSession.request({
+                method: 'POST',
+                url: '/api/scan',
+                headers: { "Content-Type": "application/json" },
+                data: data
+            }).catch(
+                function (error)
                 {
-                    factory.pollEvents();
-	            }
+                    factory.endJob(job);
+                    console.error("Error when starting scan of " + data.path + " : " + error.status);
+                }
+            );
+	  	};
+
+        // options are sent as is along with the path, see incrementalOptions.
+        factory.newScan = function (path_to_scan, type, options)
+        {
+            var job = {
+                id: Date.now().toString(36) + "-" + next_job++,
+                path: path_to_scan,
+                options: options || {},
+                started: Date.now(),
+                running: true,
+                interrupted: false,
+                replaying: false,
+                detection_seq: null,
+                detections: 0,
+                buffer: [],
+                data: ScanData.create()
             };
 
-            factory.xmlhttp.open("POST", "/api/scan", true);
-            factory.xmlhttp.setRequestHeader("X-Armadito-Token", factory.token);
-            factory.xmlhttp.setRequestHeader("Content-Type", "application/json");
-            factory.xmlhttp.send(JSON.stringify(data));
-	  	}
+            job.data.setScanConf(path_to_scan, type);
+            factory.jobs.push(job);
+            saveJobs();
+
+            // Listen before asking, the first events may come right away.
+            factory.pollEvents();
+            factory.AskForNewScan(job);
+
+            return job;
+        };
 
-	  	factory.apiUnregister = function ()
+        // Only files changed since the last clean scan of path get scanned.
+        // Without such a scan the daemon scans everything and records the
+        // fingerprints for the next time.
+        factory.incrementalOptions = function (path)
         {
-	  		factory.xmlhttp.open("GET", "/api/unregister", true);
-	  		factory.xmlhttp.setRequestHeader("X-Armadito-Token", factory.token);
-	  		factory.xmlhttp.send(null);
-	  		factory.token = null;
-	  	};
+            var last = ScanHistory.lastCleanScan(path);
+            var options = { mode: "incremental" };
+
+            if (last !== null)
+            {
+                options.since = last.since;
+                if (last.fingerprint)
+                {
+                    options.fingerprint = last.fingerprint;
+                }
+            }
+
+            return options;
+        };
 
-        factory.apiRegister = function ()
+        // Asks the daemon to abort the job. Events already in flight are
+        // drained until the daemon confirms with OnDemandCompletedEvent,
+        // or until cancel_drain_timeout when it never does.
+        factory.cancelScan = function (job)
         {
-            factory.xmlhttp.onreadystatechange = function ()
+            if (!job.running || job.data.data.canceled)
+            {
+                return;
+            }
+
+            job.data.setCanceled();
+
+            job.drain_timer = $timeout(function ()
             {
-                if (factory.xmlhttp.readyState == 4 && factory.xmlhttp.status == 200)
+                job.drain_timer = null;
+                if (job.running)
                 {
-                    var jobj = parseJson(factory.xmlhttp.responseText);
-                    factory.token = jobj.token;
-                    
-                    factory.AskForNewScan();
-	            }
-            };
+                    factory.endJob(job);
+                    $rootScope.$broadcast( "OnDemandCompletedEvent",
+                                           { event_type: "OnDemandCompletedEvent", scan_id: job.id, canceled: true },
+                                           job );
+                }
+            }, factory.cancel_drain_timeout, false);
 
-	  		factory.xmlhttp.open("GET", "/api/register", true);
-	  		factory.xmlhttp.send(null);
-	  	};
+            return ApiSession.request({
+                method: 'POST',
+                url: '/api/scan/cancel',
+                headers: { "Content-Type": "application/json" },
+                data: { scan_id: job.id }
+            }).catch(
+                function (error)
+                {
+                    console.error("Error when canceling scan of " + job.path + " : " + error.status);
+                }
+            );
+        };
+
+        // Forgets the jobs that are not running anymore.
+        factory.clearJobs = function ()
+        {
+            for (var i = factory.jobs.length - 1; i >= 0; i--)
+            {
+                if (!factory.jobs[i].running)
+                {
+                    factory.jobs[i].data.reset();
+                    factory.jobs.splice(i, 1);
+                }
+            }
+            saveJobs();
+        };
 
-        factory.newScan = function (path_to_scan)
+        // Reads the detections of a job after its last sequence number, page
+        // by page. Live detections wait in job.buffer meanwhile.
+        factory.replay = function (job)
         {
-            factory.path_to_scan = path_to_scan;
-            factory.xmlhttp = new XMLHttpRequest();
-            factory.apiRegister();
+            if (job.replaying)
+            {
+                return job.replaying;
+            }
+
+            function page()
+            {
+                var params = { scan_id: job.id, limit: factory.replay_page_size };
+
+                if (job.detection_seq !== null)
+                {
+                    params.since = job.detection_seq;
+                }
+
+                return ApiSession.request({
+                    method: 'GET',
+                    url: '/api/scan/detections',
+                    headers: { "Content-Type": "application/json" },
+                    params: params
+                }).then(function (response)
+                {
+                    var entries = response.data.entries || [];
+
+                    for (var i = 0; i < entries.length; i++)
+                    {
+                        if (entries[i].scan_status === 'malware' || entries[i].scan_status === 'suspicious')
+                        {
+                            job.data.addScannedFile(entries[i].path, entries[i].scan_status, entries[i].scan_action,
+                                                    entries[i].module_name, entries[i].module_report);
+                        }
+                        job.detection_seq = entries[i].seq;
+                    }
+
+                    if (entries.length === factory.replay_page_size)
+                    {
+                        return page();
+                    }
+                });
+            }
+
+            job.buffer = [];
+            job.replaying = page().catch(function (error)
+            {
+                console.error("Error when replaying detections of " + job.path + " : " + error.status);
+            }).finally(function ()
+            {
+                var buffered = job.buffer;
+
+                job.replaying = false;
+                job.buffer = [];
+
+                for (var i = 0; i < buffered.length; i++)
+                {
+                    applyEvent(buffered[i]);
+                }
+                changed(job);
+            });
+
+            return job.replaying;
+        };
+
+        // state is one of running, interrupted, completed or canceled.
+        function applyStatus(job, status)
+        {
+            job.data.updateCounters(status.scanned_count || 0, status.suspicious_count || 0,
+                                    status.malware_count || 0, status.progress || 0, status.skipped_count);
+
+            job.running = (status.state === "running");
+            job.interrupted = (status.state === "interrupted");
+
+            if (status.state === "canceled")
+            {
+                job.data.setCanceled();
+            }
+            if (status.state === "completed" || status.state === "canceled")
+            {
+                job.data.setCompleted();
+            }
+        }
+
+        // Listens before asking, so that no event falls between the status
+        // and the replay.
+        factory.attach = function (job)
+        {
+            factory.pollEvents();
+
+            return ApiSession.request({
+                method: 'POST',
+                url: '/api/scan/attach',
+                headers: { "Content-Type": "application/json" },
+                data: { scan_id: job.id }
+            }).then(
+                function (response)
+                {
+                    job.attach_attempt = 0;
+                    applyStatus(job, response.data);
+                    return factory.replay(job);
+                },
+                function (error)
+                {
+                    console.error("Error when reattaching to scan of " + job.path + " : " + error.status);
+
+                    if (error.status === 404)
+                    {
+                        // The daemon does not know the job anymore.
+                        factory.jobs.splice(factory.jobs.indexOf(job), 1);
+                        job.data.reset();
+                        job.running = false;
+                        return;
+                    }
+
+                    // The daemon may be starting or overloaded: keep the
+                    // job and ask again.
+                    job.attach_timer = $timeout(function ()
+                    {
+                        job.attach_timer = null;
+                        if (factory.jobs.indexOf(job) !== -1)
+                        {
+                            factory.attach(job);
+                        }
+                    }, Math.min(factory.attach_retry.max, factory.attach_retry.initial * Math.pow(2, job.attach_attempt++)), false);
+                }
+            ).finally(function ()
+            {
+                if (!job.running)
+                {
+                    factory.endJob(job);
+                }
+                changed(job);
+            });
+        };
+
+        // Finds the unfinished jobs of previous sessions again.
+        factory.reattach = function ()
+        {
+            loadSavedJobs().forEach(function (saved)
+            {
+                for (var i = 0; i < factory.jobs.length; i++)
+                {
+                    if (factory.jobs[i].id === saved.id)
+                    {
+                        return;
+                    }
+                }
+
+                var job = {
+                    id: saved.id,
+                    path: saved.path,
+                    options: saved.options || {},
+                    started: saved.started,
+                    running: true,
+                    interrupted: false,
+                    replaying: false,
+                    detection_seq: null,
+                    detections: 0,
+                    buffer: [],
+                    attach_attempt: 0,
+                    attach_timer: null,
+                    data: ScanData.create()
+                };
+
+                job.data.setScanConf(saved.path, saved.type);
+                factory.jobs.push(job);
+                factory.attach(job);
+            });
+        };
+
+        // Goes on from the checkpoint of an interrupted job.
+        factory.resumeScan = function (job)
+        {
+            if (!job.interrupted)
+            {
+                return;
+            }
+
+            job.interrupted = false;
+            job.running = true;
+            saveJobs();
+            factory.pollEvents();
+
+            return ApiSession.request({
+                method: 'POST',
+                url: '/api/scan/resume',
+                headers: { "Content-Type": "application/json" },
+                data: { scan_id: job.id }
+            }).catch(
+                function (error)
+                {
+                    console.error("Error when resuming scan of " + job.path + " : " + error.status);
+                    job.interrupted = true;
+                    factory.endJob(job);
+                }
+            ).finally(function ()
+            {
+                changed(job);
+            });
         };
 
 	  	return factory;
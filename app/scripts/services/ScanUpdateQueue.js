@@ -0,0 +1,259 @@
+/***
+
+Copyright (C) 2015, 2016 Teclib'
+
+This file is part of Armadito gui.
+
+Armadito gui is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Armadito gui is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Armadito gui.  If not, see <http://www.gnu.org/licenses/>.
+
+***/
+
+'use strict';
+
+/**
+ * @ngdoc service
+ * @name armaditoApp.ScanUpdateQueue
+ * @description
+ * # ScanUpdateQueue
+ * Coalesces scan events before they reach ScanData. Progress events are
+ * folded into the latest one and detections are queued, per scan job,
+ * then everything is applied at once on the next animation frame (or
+ * after `interval` milliseconds when set), so that listeners run one
+ * digest per flush. The totals of all jobs are kept in ScanData.
+ */
+angular.module('armaditoApp')
+    .service('ScanUpdateQueue', ['$rootScope', '$window', 'ScanData', 'ScanService', 'ScanMetrics', 'UiTrace',
+    function ($rootScope, $window, ScanData, ScanService, ScanMetrics, UiTrace) {
+
+        var factory = {};
+
+        // 0 means one flush per animation frame.
+        factory.interval = 0;
+
+        var pending = {};
+        var scheduled = false;
+        var frame = null;
+        var timer = null;
+        var listeners = [];
+
+        // UiTrace start of the oldest event waiting for a flush.
+        var queued = 0;
+
+        function schedule()
+        {
+            if (scheduled)
+            {
+                return;
+            }
+
+            scheduled = true;
+
+            if (factory.interval > 0 || !$window.requestAnimationFrame)
+            {
+                timer = $window.setTimeout(factory.flush, factory.interval || 16);
+            }
+            else
+            {
+                frame = $window.requestAnimationFrame(factory.flush);
+            }
+        }
+
+        // A flush run early, on completion, makes the scheduled one useless.
+        function unschedule()
+        {
+            if (frame !== null)
+            {
+                $window.cancelAnimationFrame(frame);
+                frame = null;
+            }
+            if (timer !== null)
+            {
+                $window.clearTimeout(timer);
+                timer = null;
+            }
+            scheduled = false;
+        }
+
+        function pendingFor(job)
+        {
+            if (!pending[job.id])
+            {
+                pending[job.id] = {
+                    job: job,
+                    progress: null,
+                    file: null,
+                    display_file: undefined,
+                    detections: [],
+                    completed: false
+                };
+            }
+            return pending[job.id];
+        }
+
+        function apply(update)
+        {
+            var scan_data = update.job.data;
+
+            if (update.file !== null)
+            {
+                scan_data.setDisplayedFile(update.file, update.display_file);
+                ScanData.setDisplayedFile(update.file, update.display_file);
+            }
+
+            if (update.progress !== null)
+            {
+                scan_data.updateCounters(update.progress.scanned_count,
+                                         update.progress.suspicious_count,
+                                         update.progress.malware_count,
+                                         update.progress.progress,
+                                         update.progress.skipped_count);
+            }
+
+            for (var i = 0; i < update.detections.length; i++)
+            {
+                scan_data.addScannedFile(update.detections[i].path,
+                                         update.detections[i].scan_status,
+                                         update.detections[i].scan_action,
+                                         update.detections[i].module_name,
+                                         update.detections[i].module_report);
+            }
+
+            if (update.completed)
+            {
+                scan_data.setCompleted();
+            }
+        }
+
+        factory.push = function (receivedEvent, job)
+        {
+            var update = pendingFor(job);
+
+            ScanMetrics.recordEvent(receivedEvent, job);
+
+            if (queued === 0)
+            {
+                queued = UiTrace.begin("event_to_dom");
+            }
+
+            if (receivedEvent.event_type === "OnDemandProgressEvent")
+            {
+                UiTrace.count("events_coalesced", (receivedEvent.coalesced || 1) - (update.progress === null ? 1 : 0));
+                update.progress = receivedEvent;
+
+                if (receivedEvent.path)
+                {
+                    update.file = receivedEvent.path;
+                    update.display_file = receivedEvent.display_file;
+                }
+            }
+            else if (receivedEvent.event_type === "DetectionEvent")
+            {
+                if (receivedEvent.scan_status === 'malware'
+                || receivedEvent.scan_status === 'suspicious')
+                {
+                    update.detections.push(receivedEvent);
+                }
+            }
+            else if (receivedEvent.event_type === "OnDemandCompletedEvent")
+            {
+                // The final counters are never delayed.
+                update.completed = true;
+                factory.flush();
+                return;
+            }
+
+            schedule();
+        };
+
+        factory.flush = function ()
+        {
+            var updates = pending;
+            var traced = UiTrace.begin("apply");
+            var i;
+
+            unschedule();
+            pending = {};
+
+            for (var id in updates)
+            {
+                if (updates.hasOwnProperty(id))
+                {
+                    apply(updates[id]);
+                }
+            }
+
+            ScanData.aggregate(ScanService.jobs.map(function (job)
+            {
+                return job.data;
+            }));
+
+            UiTrace.end("apply", traced);
+
+            var started = $window.performance.now();
+
+            for (i = 0; i < listeners.length; i++)
+            {
+                listeners[i]();
+            }
+
+            ScanMetrics.recordFlush(ScanData.data, $window.performance.now() - started);
+            UiTrace.end("event_to_dom", queued);
+            queued = 0;
+        };
+
+        factory.clear = function ()
+        {
+            unschedule();
+            pending = {};
+        };
+
+        factory.onFlush = function (listener)
+        {
+            listeners.push(listener);
+
+            return function ()
+            {
+                var index = listeners.indexOf(listener);
+                if (index !== -1)
+                {
+                    listeners.splice(index, 1);
+                }
+            };
+        };
+
+        $rootScope.$on('OnDemandProgressEvent', function (event, data, job)
+        {
+            factory.push(data, job);
+        });
+
+        $rootScope.$on('DetectionEvent', function (event, data, job)
+        {
+            factory.push(data, job);
+        });
+
+        $rootScope.$on('OnDemandCompletedEvent', function (event, data, job)
+        {
+            factory.push(data, job);
+        });
+
+        // Reattached, replayed or interrupted: counters changed at once.
+        $rootScope.$on('ScanJobChanged', function (event, job)
+        {
+            pendingFor(job);
+            schedule();
+        });
+
+        return factory;
+    }
+]);
@@ -2,99 +2,189 @@
 
 /**
  * @ngdoc service
- * @name armaditoApp.ScanService
+ * @name armaditoApp.StatusService
  * @description
- * # ScanService
+ * # StatusService
  * Service in the armaditoApp.
+ * Keeps a live copy of the daemon status. The subscription is opened once
+ * and stays open: /api/status?watch=1 answers with a full StatusEvent,
+ * after which the daemon only pushes StatusDeltaEvent with the fields and
+ * modules that changed (module state, database update completion).
+ * Every change is broadcast as "StatusEvent" with the whole status.
  */
 angular.module('armaditoApp')
-	.service('StatusService', ['$rootScope', function ($rootScope) {
+	.service('StatusService', ['$rootScope', 'ApiSession', function ($rootScope, ApiSession) {
 
 	  	var factory = {};
 
-        function parseJson(json)
+        factory.unsubscribe = null;
+        factory.status = null;
+
+        var channel_lost = false;
+
+        function findModule(status, name)
+        {
+            for (var i = 0; i < status.modules.length; i++)
+            {
+                if (status.modules[i].name === name)
+                {
+                    return status.modules[i];
+                }
+            }
+            return null;
+        }
+
+        // Also used by FleetService for the status of every host.
+        factory.fromSnapshot = function (receivedEvent)
         {
-            var parsed;
-            try {
-                parsed = JSON.parse(json);
+            return {
+                global_status: receivedEvent.global_status,
+                global_update_timestamp: receivedEvent.global_update_timestamp,
+                modules: receivedEvent.modules || []
+            };
+        };
+
+        // Module objects are updated in place so that views only redraw
+        // the rows that changed; returns the names of those modules.
+        factory.mergeDelta = function (status, receivedEvent)
+        {
+            if (receivedEvent.global_status !== undefined)
+            {
+                status.global_status = receivedEvent.global_status;
+            }
+
+            if (receivedEvent.global_update_timestamp !== undefined)
+            {
+                status.global_update_timestamp = receivedEvent.global_update_timestamp;
             }
-            catch(e)
+
+            var modules = receivedEvent.modules || [];
+            var changed = [];
+
+            for (var i = 0; i < modules.length; i++)
             {
-                console.error("Error when parsing JSON : "+e);
+                var module = findModule(status, modules[i].name);
+
+                changed.push(modules[i].name);
+
+                if (module === null)
+                {
+                    status.modules.push(modules[i]);
+                }
+                else
+                {
+                    angular.extend(module, modules[i]);
+                }
             }
-            return parsed;
+
+            return changed;
+        };
+
+        factory.applySnapshot = function (receivedEvent)
+        {
+            factory.status = factory.fromSnapshot(receivedEvent);
+        };
+
+        factory.applyDelta = function (receivedEvent)
+        {
+            return factory.mergeDelta(factory.status, receivedEvent);
         };
 
+        // changed lists the modules a delta touched, undefined when the
+        // whole status is new.
+        function broadcast(changed)
+        {
+            $rootScope.$applyAsync(function ()
+            {
+                $rootScope.$broadcast( "StatusEvent", factory.status, changed );
+            });
+        }
+
         factory.handleEvent = function (receivedEvent)
         {
             if (receivedEvent.event_type === "StatusEvent")
         	{
-        		$rootScope.$broadcast( "StatusEvent", receivedEvent );
-                factory.apiUnregister();
+                factory.applySnapshot(receivedEvent);
+                broadcast();
         	}
+            else if (receivedEvent.event_type === "StatusDeltaEvent")
+            {
+                // A delta without the state it applies to is of no use.
+                if (factory.status === null)
+                {
+                    return;
+                }
+                broadcast(factory.applyDelta(receivedEvent));
+            }
+            else if (receivedEvent.event_type === "EventGapEvent")
+            {
+                // Deltas may have been lost, start again from a snapshot.
+                factory.AskForStatus();
+            }
+            else if (receivedEvent.event_type === "ChannelStateEvent")
+            {
+                // The watch may have ended with the connection, or belong
+                // to a token the daemon replaced: ask for it again.
+                if (!receivedEvent.connected)
+                {
+                    channel_lost = true;
+                }
+                else if (channel_lost)
+                {
+                    channel_lost = false;
+                    factory.AskForStatus();
+                }
+            }
         };
 
         factory.pollEvents = function ()
         {
-	      	factory.xmlhttp.onreadystatechange = function ()
-	      	{
-                if (factory.xmlhttp.readyState == 4 && factory.xmlhttp.status == 200)
-                {
-	                var jobj = parseJson(factory.xmlhttp.responseText);
-	                factory.handleEvent(jobj);
-                 }
-	      	};
-
-	      	factory.xmlhttp.open("GET", "/api/event", true);
-	      	factory.xmlhttp.setRequestHeader("X-Armadito-Token", factory.token);
-	      	factory.xmlhttp.send(null);
+            if (factory.unsubscribe === null)
+            {
+                factory.unsubscribe = ApiSession.subscribe(factory.handleEvent);
+            }
 	  	};
 
-	  	factory.apiUnregister = function ()
+        factory.stopEvents = function ()
         {
-	  		factory.xmlhttp.open("GET", "/api/unregister", true);
-	  		factory.xmlhttp.setRequestHeader("X-Armadito-Token", factory.token);
-	  		factory.xmlhttp.send(null);
-	  		factory.token = null;
-	  	};
+            if (factory.unsubscribe !== null)
+            {
+                factory.unsubscribe();
+                factory.unsubscribe = null;
+            }
+        };
 
         factory.AskForStatus = function()
         {
-            factory.xmlhttp.onreadystatechange = function ()
-            {
-                if (factory.xmlhttp.readyState == 4 && factory.xmlhttp.status == 200)
+            return ApiSession.request({
+                method: 'GET',
+                url: '/api/status',
+                params: { watch: 1 },
+                headers: { "Content-Type": "application/json" }
+            }).catch(
+                function (error)
                 {
-                    factory.pollEvents();
-	            }
-            };
-
-		  	factory.xmlhttp.open("GET", "/api/status", true);
-		  	factory.xmlhttp.setRequestHeader("X-Armadito-Token", factory.token);
-		  	factory.xmlhttp.setRequestHeader("Content-Type", "application/json");
-	  		factory.xmlhttp.send(null);
-        }
+                    factory.stopEvents();
+                    console.error("Error when asking for status : " + error.status);
+                }
+            );
+        };
 
-        factory.apiRegister = function ()
+        // Views call this when they load: the first call subscribes, the
+        // next ones get the status already known without asking again.
+	  	factory.getStatus = function()
         {
-            factory.xmlhttp.onreadystatechange = function ()
+            if (factory.unsubscribe !== null)
             {
-                if (factory.xmlhttp.readyState == 4 && factory.xmlhttp.status == 200)
+                if (factory.status !== null)
                 {
-                    var jobj = parseJson(factory.xmlhttp.responseText);
-                    factory.token = jobj.token;
-
-                    factory.AskForStatus();
-	            }
-            };
-
-	  		factory.xmlhttp.open("GET", "/api/register", true);
-	  		factory.xmlhttp.send(null);
-	  	};
+                    broadcast();
+                }
+                return;
+            }
 
-	  	factory.getStatus = function()
-        {
-            factory.xmlhttp = new XMLHttpRequest();
-            factory.apiRegister();
+            factory.pollEvents();
+            return factory.AskForStatus();
 	  	};
 
 	  	return factory;
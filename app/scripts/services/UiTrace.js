@@ -0,0 +1,223 @@
+/***
+
+Copyright (C) 2015, 2016 Teclib'
+
+This file is part of Armadito gui.
+
+Armadito gui is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Armadito gui is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Armadito gui.  If not, see <http://www.gnu.org/licenses/>.
+
+***/
+
+'use strict';
+
+/**
+ * @ngdoc service
+ * @name armaditoApp.UiTrace
+ * @description
+ * # UiTrace
+ * Opt-in tracing of the path from a daemon event to the DOM. Hot paths
+ * wrap their work in begin()/end(), which adds a User Timing measure
+ * named "armadito:<name>" for the browser profiler and keeps count, total
+ * and max per name; count() keeps plain counters. While enabled, figures
+ * are uploaded to /api/uimetrics every `upload_interval` milliseconds so
+ * that UI lag can be put next to the daemon load of the host.
+ * Disabled, begin() and end() cost a test.
+ */
+angular.module('armaditoApp')
+    .service('UiTrace', ['$window', '$timeout', 'ApiSession', 'ScanMetrics',
+    function ($window, $timeout, ApiSession, ScanMetrics) {
+
+        var factory = {};
+
+        var STORAGE_KEY = "armadito.ui_trace";
+        var PREFIX = "armadito:";
+
+        factory.upload_interval = 30000;
+
+        var performance = $window.performance;
+        var user_timing = !!(performance && performance.mark && performance.measure);
+        var counters, measures, since, upload_timer = null;
+
+        factory.reset = function ()
+        {
+            counters = {};
+            measures = {};
+            since = Date.now();
+
+            if (user_timing && performance.clearMeasures)
+            {
+                performance.clearMeasures();
+            }
+        };
+
+        factory.count = function (name, n)
+        {
+            if (factory.enabled)
+            {
+                counters[name] = (counters[name] || 0) + (n === undefined ? 1 : n);
+            }
+        };
+
+        // Returns what end() needs, 0 when tracing is off.
+        factory.begin = function (name)
+        {
+            if (!factory.enabled)
+            {
+                return 0;
+            }
+
+            if (user_timing)
+            {
+                performance.mark(PREFIX + name + ":start");
+            }
+
+            return performance.now();
+        };
+
+        factory.end = function (name, started)
+        {
+            if (!factory.enabled || started === 0)
+            {
+                return;
+            }
+
+            factory.record(name, performance.now() - started);
+
+            if (user_timing)
+            {
+                try {
+                    performance.measure(PREFIX + name, PREFIX + name + ":start");
+                }
+                catch(e)
+                {
+                    // The start mark was cleared by a reset in between.
+                }
+                performance.clearMarks(PREFIX + name + ":start");
+            }
+        };
+
+        // Durations measured elsewhere, in milliseconds.
+        factory.record = function (name, ms)
+        {
+            if (!factory.enabled)
+            {
+                return;
+            }
+
+            var measure = measures[name];
+
+            if (measure === undefined)
+            {
+                measure = measures[name] = { count: 0, total_ms: 0, max_ms: 0 };
+            }
+
+            measure.count++;
+            measure.total_ms += ms;
+            measure.max_ms = Math.max(measure.max_ms, ms);
+        };
+
+        factory.snapshot = function ()
+        {
+            var snapshot = {
+                since: since,
+                until: Date.now(),
+                counters: angular.copy(counters),
+                measures: {}
+            };
+
+            for (var name in measures)
+            {
+                if (measures.hasOwnProperty(name))
+                {
+                    snapshot.measures[name] = {
+                        count: measures[name].count,
+                        avg_ms: Math.round(measures[name].total_ms / measures[name].count * 100) / 100,
+                        max_ms: Math.round(measures[name].max_ms * 100) / 100
+                    };
+                }
+            }
+
+            return snapshot;
+        };
+
+        factory.upload = function ()
+        {
+            var snapshot = factory.snapshot();
+
+            if (angular.equals(snapshot.counters, {}) && angular.equals(snapshot.measures, {}))
+            {
+                return;
+            }
+
+            snapshot.scan = ScanMetrics.snapshot();
+            factory.reset();
+
+            return ApiSession.request({ method: 'POST', url: '/api/uimetrics', data: snapshot })
+                .catch(function (error)
+                {
+                    console.error("Error when uploading UI metrics : " + error.status);
+                });
+        };
+
+        function scheduleUpload()
+        {
+            upload_timer = $timeout(function ()
+            {
+                factory.upload();
+                scheduleUpload();
+            }, factory.upload_interval, false);
+        }
+
+        factory.setEnabled = function (enabled)
+        {
+            factory.enabled = !!enabled;
+            factory.reset();
+
+            if (upload_timer !== null)
+            {
+                $timeout.cancel(upload_timer);
+                upload_timer = null;
+            }
+
+            if (factory.enabled && factory.upload_interval > 0)
+            {
+                scheduleUpload();
+            }
+
+            try {
+                $window.localStorage.setItem(STORAGE_KEY, JSON.stringify(factory.enabled));
+            }
+            catch(e)
+            {
+                console.error("Error when saving trace setting : " + e);
+            }
+        };
+
+        factory.enabled = false;
+        factory.reset();
+
+        try {
+            if (JSON.parse($window.localStorage.getItem(STORAGE_KEY)) === true)
+            {
+                factory.setEnabled(true);
+            }
+        }
+        catch(e)
+        {
+            console.error("Error when reading trace setting : " + e);
+        }
+
+        return factory;
+    }
+]);
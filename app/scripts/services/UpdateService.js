@@ -0,0 +1,315 @@
+/***
+
+Copyright (C) 2015, 2016 Teclib'
+
+This file is part of Armadito gui.
+
+Armadito gui is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Armadito gui is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Armadito gui.  If not, see <http://www.gnu.org/licenses/>.
+
+***/
+
+'use strict';
+
+/**
+ * @ngdoc service
+ * @name armaditoApp.UpdateService
+ * @description
+ * # UpdateService
+ * Starts a signature update on the daemon with POST /api/update and
+ * follows it on the event channel: UpdateProgressEvent gives, per module,
+ * the bytes downloaded, whether a delta or the full database is fetched
+ * and the step reached; UpdateCompletedEvent ends the update. Both are
+ * tagged with the op_id sent with the request. Module statuses carried by
+ * the events go through StatusService as deltas, so that only the rows
+ * of the updated modules are redrawn. Each change is broadcast as
+ * "UpdateProgress" with the update. When events may have been lost, or
+ * none came for `timeout` milliseconds, the update's state is asked
+ * again from GET /api/update.
+ */
+angular.module('armaditoApp')
+    .service('UpdateService', ['$rootScope', '$q', '$timeout', 'ApiSession', 'StatusService',
+    function ($rootScope, $q, $timeout, ApiSession, StatusService) {
+
+        var factory = {};
+
+        factory.current = null;
+        factory.unsubscribe = null;
+        factory.timeout = 120000;
+
+        var watchdog = null;
+
+        var next_update = 1;
+
+        function broadcast(update)
+        {
+            $rootScope.$applyAsync(function ()
+            {
+                $rootScope.$broadcast( "UpdateProgress", update );
+            });
+        }
+
+        function moduleOf(update, name)
+        {
+            if (!update.modules.hasOwnProperty(name))
+            {
+                update.modules[name] = {
+                    name: name,
+                    state: "pending",
+                    mode: null,
+                    downloaded_bytes: 0,
+                    total_bytes: null
+                };
+            }
+            return update.modules[name];
+        }
+
+        // Totals of the modules whose size is known.
+        function sumUp(update)
+        {
+            update.downloaded_bytes = 0;
+            update.total_bytes = 0;
+
+            for (var name in update.modules)
+            {
+                if (update.modules.hasOwnProperty(name))
+                {
+                    update.downloaded_bytes += update.modules[name].downloaded_bytes;
+                    update.total_bytes += update.modules[name].total_bytes || 0;
+                }
+            }
+        }
+
+        function applyStatus(receivedEvent)
+        {
+            if (receivedEvent.module_status)
+            {
+                StatusService.handleEvent({ event_type: "StatusDeltaEvent", modules: [receivedEvent.module_status] });
+            }
+        }
+
+        function endUpdate(update, failed)
+        {
+            update.running = false;
+            update.failed = failed;
+
+            for (var i = 0; i < failed.length; i++)
+            {
+                moduleOf(update, failed[i]).state = "failed";
+            }
+
+            if (watchdog !== null)
+            {
+                $timeout.cancel(watchdog);
+                watchdog = null;
+            }
+            factory.stopEvents();
+            broadcast(update);
+        }
+
+        function applyProgress(update, progress)
+        {
+            var module = moduleOf(update, progress.module_name);
+            var fields = ["state", "mode", "downloaded_bytes", "total_bytes"];
+
+            for (var i = 0; i < fields.length; i++)
+            {
+                if (progress[fields[i]] !== undefined)
+                {
+                    module[fields[i]] = progress[fields[i]];
+                }
+            }
+
+            applyStatus(progress);
+        }
+
+        function applyCompletion(update, completion)
+        {
+            (completion.modules || []).forEach(function (status)
+            {
+                applyStatus({ module_status: status });
+            });
+            endUpdate(update, completion.failed || []);
+        }
+
+        // Restarted by every event of the update.
+        function watch(update)
+        {
+            if (watchdog !== null)
+            {
+                $timeout.cancel(watchdog);
+            }
+
+            watchdog = $timeout(function ()
+            {
+                watchdog = null;
+                factory.refresh(update);
+            }, factory.timeout, false);
+        }
+
+        // Answers {state: "running" | "completed", modules: [progress,
+        // as in UpdateProgressEvent], failed, statuses}.
+        factory.refresh = function (update)
+        {
+            return ApiSession.request({
+                method: 'GET',
+                url: '/api/update',
+                params: { op_id: update.id }
+            }).then(
+                function (response)
+                {
+                    if (!update.running)
+                    {
+                        return;
+                    }
+
+                    (response.data.modules || []).forEach(function (progress)
+                    {
+                        applyProgress(update, progress);
+                    });
+                    sumUp(update);
+
+                    if (response.data.state === "running")
+                    {
+                        watch(update);
+                        broadcast(update);
+                    }
+                    else
+                    {
+                        applyCompletion(update, { modules: response.data.statuses, failed: response.data.failed });
+                    }
+                },
+                function (error)
+                {
+                    // Unknown or unreachable: it cannot be followed anymore.
+                    console.error("Error when asking for the update state : " + error.status);
+                    if (update.running)
+                    {
+                        update.error = error.status;
+                        endUpdate(update, []);
+                    }
+                }
+            );
+        };
+
+        factory.handleEvent = function (receivedEvent)
+        {
+            var update = factory.current;
+
+            if (update === null || !update.running)
+            {
+                return;
+            }
+
+            // The completion may be among the lost events.
+            if (receivedEvent.event_type === "EventGapEvent")
+            {
+                factory.refresh(update);
+                return;
+            }
+
+            if (receivedEvent.op_id !== update.id)
+            {
+                return;
+            }
+
+            if (receivedEvent.event_type === "UpdateProgressEvent")
+            {
+                applyProgress(update, receivedEvent);
+                sumUp(update);
+                watch(update);
+                broadcast(update);
+            }
+            else if (receivedEvent.event_type === "UpdateCompletedEvent")
+            {
+                applyCompletion(update, receivedEvent);
+            }
+        };
+
+        factory.pollEvents = function ()
+        {
+            if (factory.unsubscribe === null)
+            {
+                factory.unsubscribe = ApiSession.subscribe(factory.handleEvent);
+            }
+        };
+
+        factory.stopEvents = function ()
+        {
+            if (factory.unsubscribe !== null)
+            {
+                factory.unsubscribe();
+                factory.unsubscribe = null;
+            }
+        };
+
+        factory.running = function ()
+        {
+            return factory.current !== null && factory.current.running;
+        };
+
+        // modules restricts the update to some modules, all by default.
+        factory.start = function (modules)
+        {
+            if (factory.running())
+            {
+                return factory.current;
+            }
+
+            var update = {
+                id: Date.now().toString(36) + "-" + next_update++,
+                modules: {},
+                downloaded_bytes: 0,
+                total_bytes: 0,
+                failed: [],
+                running: true
+            };
+
+            var data = { op_id: update.id };
+            if (modules && modules.length > 0)
+            {
+                data.modules = modules;
+            }
+
+            factory.current = update;
+
+            // Listen before asking, progress may come right away.
+            factory.pollEvents();
+            watch(update);
+            broadcast(update);
+
+            update.promise = ApiSession.request({
+                method: 'POST',
+                url: '/api/update',
+                headers: { "Content-Type": "application/json" },
+                data: data
+            }).then(
+                function ()
+                {
+                    return update;
+                },
+                function (error)
+                {
+                    update.error = error.status;
+                    endUpdate(update, []);
+                    console.error("Error when starting the update : " + error.status);
+                    return $q.reject(error);
+                }
+            );
+
+            return update;
+        };
+
+        return factory;
+    }
+]);
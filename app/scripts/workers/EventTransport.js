@@ -0,0 +1,426 @@
+/***
+
+Copyright (C) 2015, 2016 Teclib'
+
+This file is part of Armadito gui.
+
+Armadito gui is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Armadito gui is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Armadito gui.  If not, see <http://www.gnu.org/licenses/>.
+
+***/
+
+'use strict';
+
+/*
+ * Transport of the daemon events, shared by the EventChannel service and
+ * the EventWorker, which runs it off the UI thread. Plain script: it is
+ * loaded by index.html and by importScripts() alike, and only relies on
+ * what both contexts provide.
+ *
+ * A channel uses a server-sent events stream on /api/event/stream and
+ * falls back to long-polling /api/event when the daemon does not support
+ * streaming. Both transports may carry either a single event or an array
+ * of events. A lost connection is reopened with exponential backoff,
+ * resuming after the last sequence number seen; a stream that worked but
+ * fails to reopen is checked with one long-poll, so that a token refused
+ * by a restarted daemon reaches onAuthError. Events replayed twice are
+ * dropped and missing ones are reported to the onGap callback. onState,
+ * when given, is called with false when the connection is lost and with
+ * true once it works again. `settings` holds the batch, backoff and
+ * timeout values of EventChannel and the base_url of the daemon, empty
+ * for the one serving the UI.
+ */
+(function (self) {
+
+    var EventTransport = {};
+
+    function parseJson(json)
+    {
+        var parsed;
+        try {
+            parsed = JSON.parse(json);
+        }
+        catch(e)
+        {
+            console.error("Error when parsing JSON : "+e);
+        }
+        return parsed;
+    }
+
+    // null when the frame is malformed, so that it can be fetched again.
+    function decodeEvents(json)
+    {
+        var parsed = parseJson(json);
+
+        if (Array.isArray(parsed))
+        {
+            return parsed;
+        }
+        else if (parsed !== null && typeof parsed === "object")
+        {
+            return [parsed];
+        }
+
+        return null;
+    }
+
+    EventTransport.parseEvents = function (json)
+    {
+        return decodeEvents(json) || [];
+    };
+
+    EventTransport.eventUrl = function (settings, since)
+    {
+        var url = (settings.base_url || "") + "/api/event?max_events=" + settings.batch.max_events
+                + "&max_wait=" + settings.batch.max_wait;
+
+        if (since !== null && since !== undefined)
+        {
+            url += "&since=" + since;
+        }
+
+        return url;
+    };
+
+    // Jittered, so that channels dropped together do not come back in
+    // lockstep on a loaded daemon.
+    EventTransport.retryDelay = function (settings, attempt)
+    {
+        var delay = Math.min(settings.backoff.max, settings.backoff.initial * Math.pow(2, attempt));
+        return Math.round(delay / 2 + Math.random() * delay / 2);
+    };
+
+    // Leaves two heartbeats to come in before stall_timeout.
+    EventTransport.heartbeatInterval = function (settings)
+    {
+        return Math.floor(settings.stall_timeout / 3);
+    };
+
+    function Channel(settings, token, onEvent, onAuthError, onGap, onState)
+    {
+        this.settings = settings;
+        this.token = token;
+        this.onEvent = onEvent;
+        this.onAuthError = onAuthError;
+        this.onGap = onGap;
+        this.onState = onState;
+        this.connected = null;
+        this.closed = false;
+        this.source = null;
+        this.stream_opened = false;
+        this.stream_worked = false;
+        this.onStreamRefused = null;
+        this.xmlhttp = null;
+        this.last_seq = null;
+        this.attempt = 0;
+        this.retry_timer = null;
+        this.stall_timer = null;
+        this.poll_timer = null;
+    }
+
+    Channel.prototype.dispatch = function (receivedEvents)
+    {
+        for (var i = 0; i < receivedEvents.length && !this.closed; i++)
+        {
+            var receivedEvent = receivedEvents[i];
+
+            if (!receivedEvent)
+            {
+                continue;
+            }
+
+            if (typeof receivedEvent.seq === "number")
+            {
+                if (this.last_seq !== null && receivedEvent.seq <= this.last_seq)
+                {
+                    continue;
+                }
+
+                if (this.last_seq !== null && receivedEvent.seq > this.last_seq + 1 && this.onGap)
+                {
+                    this.onGap(this.last_seq + 1, receivedEvent.seq - 1);
+                }
+
+                this.last_seq = receivedEvent.seq;
+            }
+
+            if (!this.closed)
+            {
+                this.onEvent(receivedEvent);
+            }
+        }
+    };
+
+    Channel.prototype.setConnected = function (connected)
+    {
+        if (this.connected !== connected)
+        {
+            this.connected = connected;
+            if (this.onState)
+            {
+                this.onState(connected);
+            }
+        }
+    };
+
+    Channel.prototype.connect = function ()
+    {
+        this.stream_opened = false;
+
+        if (this.settings.streaming_supported)
+        {
+            this.openStream();
+        }
+        else
+        {
+            this.pollEvents();
+        }
+    };
+
+    Channel.prototype.retry = function (reason)
+    {
+        var channel = this;
+
+        if (channel.closed || channel.retry_timer !== null)
+        {
+            return;
+        }
+
+        var delay = EventTransport.retryDelay(channel.settings, channel.attempt++);
+        console.warn("Event channel lost (" + reason + "), reconnecting in " + delay + " ms");
+        channel.setConnected(false);
+
+        channel.retry_timer = setTimeout(function ()
+        {
+            channel.retry_timer = null;
+            if (!channel.closed)
+            {
+                channel.connect();
+            }
+        }, delay);
+    };
+
+    Channel.prototype.watchStream = function ()
+    {
+        var channel = this;
+
+        clearTimeout(channel.stall_timer);
+        channel.stall_timer = setTimeout(function ()
+        {
+            channel.stall_timer = null;
+            channel.closeStream();
+            channel.retry("stream stalled");
+        }, channel.settings.stall_timeout);
+    };
+
+    Channel.prototype.closeStream = function ()
+    {
+        clearTimeout(this.stall_timer);
+        this.stall_timer = null;
+
+        if (this.source !== null)
+        {
+            this.source.close();
+            this.source = null;
+        }
+    };
+
+    Channel.prototype.openStream = function ()
+    {
+        var channel = this;
+
+        // EventSource cannot set headers, the token goes in the query. The
+        // daemon sends a "heartbeat" event whenever the stream was idle for
+        // that long, so that silence means a stalled stream.
+        var url = (channel.settings.base_url || "") + "/api/event/stream?token=" + encodeURIComponent(channel.token)
+                + "&heartbeat=" + EventTransport.heartbeatInterval(channel.settings);
+        if (channel.last_seq !== null)
+        {
+            url += "&since=" + channel.last_seq;
+        }
+
+        channel.source = new EventSource(url);
+
+        channel.source.onopen = function ()
+        {
+            channel.stream_opened = true;
+            channel.stream_worked = true;
+            channel.attempt = 0;
+            channel.setConnected(true);
+            channel.watchStream();
+        };
+
+        channel.source.addEventListener("heartbeat", function ()
+        {
+            channel.watchStream();
+        });
+
+        channel.source.onmessage = function (e)
+        {
+            var receivedEvents = decodeEvents(e.data);
+
+            if (receivedEvents === null)
+            {
+                // Reopening resumes right before the lost frame.
+                channel.closeStream();
+                channel.retry("malformed event");
+                return;
+            }
+
+            channel.watchStream();
+            channel.dispatch(receivedEvents);
+        };
+
+        channel.source.onerror = function ()
+        {
+            if (channel.closed || channel.source === null)
+            {
+                return;
+            }
+
+            if (!channel.stream_opened && !channel.stream_worked)
+            {
+                // Never worked for this channel: the daemon has no stream.
+                channel.closeStream();
+                channel.settings.streaming_supported = false;
+                if (channel.onStreamRefused)
+                {
+                    channel.onStreamRefused();
+                }
+                channel.pollEvents();
+            }
+            else if (!channel.stream_opened)
+            {
+                // Worked before: EventSource does not tell why it failed, a
+                // daemon restarted since may refuse the token. One long-poll
+                // finds out, and reopens the stream when it is answered.
+                channel.closeStream();
+                channel.pollEvents(true);
+            }
+            else if (channel.source.readyState === 2)
+            {
+                // EventSource gave up reconnecting by itself.
+                channel.closeStream();
+                channel.retry("stream closed");
+            }
+        };
+    };
+
+    // `once` polls a single time before going back to the stream.
+    Channel.prototype.pollEvents = function (once)
+    {
+        var channel = this;
+        var xmlhttp = new XMLHttpRequest();
+        var timed_out = false;
+
+        // A request shed by a loaded daemon would otherwise hang forever.
+        clearTimeout(channel.poll_timer);
+        channel.poll_timer = setTimeout(function ()
+        {
+            channel.poll_timer = null;
+            timed_out = true;
+            xmlhttp.abort();
+            if (!channel.closed)
+            {
+                channel.pollEvents(once);
+            }
+        }, channel.settings.request_timeout);
+
+        channel.xmlhttp = xmlhttp;
+
+        xmlhttp.onreadystatechange = function ()
+        {
+            if (xmlhttp.readyState != 4)
+            {
+                return;
+            }
+
+            clearTimeout(channel.poll_timer);
+            channel.poll_timer = null;
+
+            if (timed_out || channel.closed)
+            {
+                return;
+            }
+
+            if (xmlhttp.status == 200)
+            {
+                var receivedEvents = decodeEvents(xmlhttp.responseText);
+
+                if (receivedEvents === null)
+                {
+                    channel.retry("malformed response");
+                    return;
+                }
+
+                channel.attempt = 0;
+                channel.setConnected(true);
+                channel.dispatch(receivedEvents);
+
+                if (channel.closed)
+                {
+                    return;
+                }
+
+                if (once)
+                {
+                    channel.connect();
+                }
+                else
+                {
+                    channel.pollEvents();
+                }
+            }
+            else if (xmlhttp.status == 401 || xmlhttp.status == 403)
+            {
+                channel.close();
+                if (channel.onAuthError)
+                {
+                    channel.onAuthError();
+                }
+            }
+            else
+            {
+                channel.retry("HTTP status " + xmlhttp.status);
+            }
+        };
+
+        xmlhttp.open("GET", EventTransport.eventUrl(channel.settings, channel.last_seq), true);
+        xmlhttp.setRequestHeader("X-Armadito-Token", channel.token);
+        xmlhttp.send(null);
+    };
+
+    Channel.prototype.close = function ()
+    {
+        this.closed = true;
+
+        this.closeStream();
+
+        clearTimeout(this.retry_timer);
+        this.retry_timer = null;
+        clearTimeout(this.poll_timer);
+        this.poll_timer = null;
+
+        if (this.xmlhttp !== null)
+        {
+            this.xmlhttp.onreadystatechange = null;
+            this.xmlhttp.abort();
+            this.xmlhttp = null;
+        }
+    };
+
+    EventTransport.Channel = Channel;
+
+    self.EventTransport = EventTransport;
+
+})(self);
@@ -0,0 +1,150 @@
+/***
+
+Copyright (C) 2015, 2016 Teclib'
+
+This file is part of Armadito gui.
+
+Armadito gui is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Armadito gui is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Armadito gui.  If not, see <http://www.gnu.org/licenses/>.
+
+***/
+
+'use strict';
+
+/*
+ * Web Worker owning the event channel of a token, see EventChannel.
+ * Frames are received and decoded here, then posted to the UI thread in
+ * batches: progress events of a scan are folded into the last one of the
+ * batch (their counters are absolute) and its path is truncated for
+ * display, so the UI thread only gets what it will apply.
+ *
+ * Receives {open: {token, settings}} and {close: true}; posts
+ * {events: [...]}, {gap: [first_seq, last_seq]}, {connected: bool},
+ * {streaming_supported: false} and {auth_error: true}.
+ */
+
+importScripts("EventTransport.js");
+
+var channel = null;
+var batch = [];
+var scheduled = false;
+
+var DISPLAY_BEGIN = 24;
+var DISPLAY_END = 23;
+
+// Same as the strLimit filter.
+function displayPath(path)
+{
+    if (!path || path.length <= DISPLAY_BEGIN + DISPLAY_END)
+    {
+        return path || "";
+    }
+
+    return path.substr(0, DISPLAY_BEGIN) + "..." + path.substr(path.length - DISPLAY_END);
+}
+
+// Keeps the last progress event of each scan, at its place in the batch.
+function fold(events)
+{
+    var last = {};
+    var folded = [];
+    var i, key;
+
+    for (i = 0; i < events.length; i++)
+    {
+        if (events[i].event_type === "OnDemandProgressEvent")
+        {
+            key = String(events[i].scan_id);
+            last[key] = { index: i, count: last[key] ? last[key].count + 1 : 1 };
+        }
+    }
+
+    for (i = 0; i < events.length; i++)
+    {
+        if (events[i].event_type === "OnDemandProgressEvent")
+        {
+            key = String(events[i].scan_id);
+            if (last[key].index !== i)
+            {
+                continue;
+            }
+            events[i].coalesced = last[key].count;
+            events[i].display_file = displayPath(events[i].path);
+        }
+        folded.push(events[i]);
+    }
+
+    return folded;
+}
+
+function flush()
+{
+    scheduled = false;
+
+    if (batch.length > 0)
+    {
+        self.postMessage({ events: fold(batch) });
+        batch = [];
+    }
+}
+
+// A response is dispatched event by event: post once it is all done.
+function queue(receivedEvent)
+{
+    batch.push(receivedEvent);
+
+    if (!scheduled)
+    {
+        scheduled = true;
+        setTimeout(flush, 0);
+    }
+}
+
+self.onmessage = function (e)
+{
+    if (e.data.open && channel === null)
+    {
+        var settings = e.data.open.settings;
+
+        settings.streaming_supported = settings.streaming_supported && (typeof self.EventSource !== "undefined");
+
+        channel = new self.EventTransport.Channel(settings, e.data.open.token, queue, function ()
+        {
+            flush();
+            self.postMessage({ auth_error: true });
+        }, function (first_seq, last_seq)
+        {
+            // Keeps the gap in order with the events around it.
+            flush();
+            self.postMessage({ gap: [first_seq, last_seq] });
+        }, function (connected)
+        {
+            flush();
+            self.postMessage({ connected: connected });
+        });
+
+        // Remembered by EventChannel, so that later channels do not try again.
+        channel.onStreamRefused = function ()
+        {
+            self.postMessage({ streaming_supported: false });
+        };
+
+        channel.connect();
+    }
+    else if (e.data.close && channel !== null)
+    {
+        channel.close();
+        channel = null;
+        batch = [];
+    }
+};
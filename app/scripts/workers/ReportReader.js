@@ -0,0 +1,158 @@
+/***
+
+Copyright (C) 2015, 2016 Teclib'
+
+This file is part of Armadito gui.
+
+Armadito gui is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Armadito gui is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Armadito gui.  If not, see <http://www.gnu.org/licenses/>.
+
+***/
+
+'use strict';
+
+/*
+ * Web Worker reading a scan report, see ReportService.
+ * A report is NDJSON: a header line {report, scan_id, path, type, started,
+ * completed, scanned_count, suspicious_count, malware_count} followed by
+ * one line per detection {path, scan_status, scan_action, module_name,
+ * module_report}. The body is parsed as it arrives and detections are
+ * posted back in batches, so neither thread ever holds the whole text.
+ *
+ * Receives {url, token, batch_size}, posts {header}, {rows, loaded},
+ * then {done: true, loaded} or {error}.
+ */
+
+var batch_size = 2000;
+var pending = "";
+var rows = [];
+var loaded = 0;
+var header_seen = false;
+
+function flush()
+{
+    if (rows.length > 0)
+    {
+        self.postMessage({ rows: rows, loaded: loaded });
+        rows = [];
+    }
+}
+
+function parseLine(line)
+{
+    var parsed;
+
+    if (line.trim() === "")
+    {
+        return;
+    }
+
+    try {
+        parsed = JSON.parse(line);
+    }
+    catch(e)
+    {
+        console.error("Error when parsing report line : " + e);
+        return;
+    }
+
+    if (!header_seen && parsed.report !== undefined)
+    {
+        header_seen = true;
+        self.postMessage({ header: parsed });
+        return;
+    }
+
+    rows.push(parsed);
+    loaded++;
+
+    if (rows.length >= batch_size)
+    {
+        flush();
+    }
+}
+
+// Parses the complete lines of text, keeping the last partial one.
+function parseChunk(text)
+{
+    var lines = (pending + text).split("\n");
+    pending = lines.pop();
+
+    for (var i = 0; i < lines.length; i++)
+    {
+        parseLine(lines[i]);
+    }
+}
+
+function finish()
+{
+    parseLine(pending);
+    pending = "";
+    flush();
+    self.postMessage({ done: true, loaded: loaded });
+}
+
+function fail(error)
+{
+    flush();
+    self.postMessage({ error: String(error) });
+}
+
+function read(url, token)
+{
+    self.fetch(url, { headers: { "X-Armadito-Token": token } }).then(function (response)
+    {
+        if (!response.ok)
+        {
+            throw "HTTP status " + response.status;
+        }
+
+        // Without streamed bodies, the text is still parsed off the UI thread.
+        if (!response.body || !self.TextDecoder)
+        {
+            return response.text().then(function (text)
+            {
+                parseChunk(text);
+                finish();
+            });
+        }
+
+        var reader = response.body.getReader();
+        var decoder = new self.TextDecoder("utf-8");
+
+        function next()
+        {
+            return reader.read().then(function (result)
+            {
+                if (result.done)
+                {
+                    parseChunk(decoder.decode());
+                    finish();
+                    return;
+                }
+
+                parseChunk(decoder.decode(result.value, { stream: true }));
+                flush();
+                return next();
+            });
+        }
+
+        return next();
+    }).catch(fail);
+}
+
+self.onmessage = function (e)
+{
+    batch_size = e.data.batch_size || batch_size;
+    read(e.data.url, e.data.token);
+};
@@ -0,0 +1,121 @@
+/***
+
+Copyright (C) 2015, 2016 Teclib'
+
+This file is part of Armadito gui.
+
+Armadito gui is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Armadito gui is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Armadito gui.  If not, see <http://www.gnu.org/licenses/>.
+
+***/
+
+'use strict';
+
+/*
+ * Service worker keeping the application shell: index.html, scripts,
+ * styles, fonts and images are answered from a cache so that the UI does
+ * not wait on a busy daemon to start; /api/ requests always go to the
+ * daemon. The 'shellcache' task of the build fills in VERSION and SHELL
+ * (see Gruntfile.js): each build opens a new cache and drops the previous
+ * ones. From the sources VERSION stays null, nothing is cached and caches
+ * left by a build are removed.
+ */
+
+var VERSION = null;
+var SHELL = [];
+
+var PREFIX = "armadito-shell-";
+var CACHE = PREFIX + VERSION;
+
+function isApi(url)
+{
+    return url.origin !== self.location.origin || url.pathname.indexOf("/api/") === 0;
+}
+
+self.addEventListener("install", function (event)
+{
+    if (VERSION !== null)
+    {
+        event.waitUntil(caches.open(CACHE).then(function (cache)
+        {
+            return cache.addAll(SHELL);
+        }));
+    }
+
+    self.skipWaiting();
+});
+
+self.addEventListener("activate", function (event)
+{
+    event.waitUntil(caches.keys().then(function (names)
+    {
+        return Promise.all(names.filter(function (name)
+        {
+            return name.indexOf(PREFIX) === 0 && (VERSION === null || name !== CACHE);
+        }).map(function (name)
+        {
+            return caches.delete(name);
+        }));
+    }).then(function ()
+    {
+        return self.clients.claim();
+    }));
+});
+
+// Files of the shell are revisioned by the build, so whatever is missing
+// from the cache can be kept once fetched.
+function fromCache(request)
+{
+    return caches.open(CACHE).then(function (cache)
+    {
+        return cache.match(request).then(function (cached)
+        {
+            if (cached)
+            {
+                return cached;
+            }
+
+            return fetch(request).then(function (response)
+            {
+                if (response.ok)
+                {
+                    cache.put(request, response.clone());
+                }
+                return response;
+            });
+        });
+    });
+}
+
+self.addEventListener("fetch", function (event)
+{
+    var request = event.request;
+    var url = new URL(request.url);
+
+    if (VERSION === null || request.method !== "GET" || isApi(url))
+    {
+        return;
+    }
+
+    // Every route of the application is index.html.
+    if (request.mode === "navigate")
+    {
+        event.respondWith(caches.match(new URL("index.html", self.registration.scope).href).then(function (cached)
+        {
+            return cached || fetch(request);
+        }));
+        return;
+    }
+
+    event.respondWith(fromCache(request));
+});
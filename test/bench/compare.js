@@ -0,0 +1,76 @@
+#!/usr/bin/env node
+// Compares the benchmark results of two commits in bench_output.txt.
+//
+//   node test/bench/compare.js <base commit> <head commit> [bench_output.txt]
+//
+// Commits may be abbreviated; the last result of each benchmark wins.
+
+'use strict';
+
+var fs = require('fs');
+
+var base = process.argv[2];
+var head = process.argv[3];
+var file = process.argv[4] || 'bench_output.txt';
+
+if (!base || !head) {
+  console.error('usage: compare.js <base commit> <head commit> [bench_output.txt]');
+  process.exit(1);
+}
+
+function matches(commit, prefix) {
+  return commit && commit.indexOf(prefix) === 0;
+}
+
+var results = {base: {}, head: {}};
+
+fs.readFileSync(file, 'utf8').split('\n').forEach(function (line) {
+  if (!line.trim()) {
+    return;
+  }
+  var result = JSON.parse(line);
+  if (matches(result.commit, base)) {
+    results.base[result.name] = result.metrics;
+  }
+  if (matches(result.commit, head)) {
+    results.head[result.name] = result.metrics;
+  }
+});
+
+// Flattens {digest_ms: {mean: 1}} into {'digest_ms.mean': 1}.
+function flatten(metrics, prefix, into) {
+  Object.keys(metrics || {}).forEach(function (key) {
+    var value = metrics[key];
+    if (value !== null && typeof value === 'object') {
+      flatten(value, prefix + key + '.', into);
+    }
+    else if (typeof value === 'number') {
+      into[prefix + key] = value;
+    }
+  });
+  return into;
+}
+
+function pad(text, width) {
+  text = String(text);
+  while (text.length < width) {
+    text += ' ';
+  }
+  return text;
+}
+
+Object.keys(results.head).forEach(function (name) {
+  var before = flatten(results.base[name], '', {});
+  var after = flatten(results.head[name], '', {});
+
+  console.log(name);
+  Object.keys(after).forEach(function (metric) {
+    var change = '';
+    if (before[metric] !== undefined && before[metric] !== 0) {
+      var ratio = (after[metric] - before[metric]) / before[metric] * 100;
+      change = (ratio >= 0 ? '+' : '') + ratio.toFixed(1) + '%';
+    }
+    console.log('  ' + pad(metric, 28) + pad(before[metric] === undefined ? '-' : before[metric], 12)
+                + pad(after[metric], 12) + change);
+  });
+});
@@ -0,0 +1,105 @@
+// Karma configuration of the benchmarks, see test/bench/README.md.
+// Run with `grunt bench`; results are appended to bench_output.txt.
+'use strict';
+
+var fs = require('fs');
+var execSync = require('child_process').execSync;
+
+function commit() {
+  try {
+    return execSync('git rev-parse --short HEAD', {encoding: 'utf8'}).trim();
+  }
+  catch (e) {
+    return 'unknown';
+  }
+}
+
+// Collects the BENCH lines logged by the benchmarks, one JSON result each.
+function BenchReporter(baseReporterDecorator, config) {
+  var output = config.benchOutput || 'bench_output.txt';
+  var revision = commit();
+
+  baseReporterDecorator(this);
+
+  this.onBrowserLog = function (browser, log) {
+    var text = String(log).replace(/^'|'$/g, '');
+    if (text.indexOf('BENCH ') !== 0) {
+      return;
+    }
+
+    var result = JSON.parse(text.substr(6));
+    result.commit = revision;
+    result.browser = browser.name;
+    result.date = new Date().toISOString();
+
+    fs.appendFileSync(output, JSON.stringify(result) + '\n');
+    process.stdout.write(result.name + ': ' + JSON.stringify(result.metrics) + '\n');
+  };
+}
+BenchReporter.$inject = ['baseReporterDecorator', 'config'];
+
+// Arguments after `--` reach the benchmarks as __karma__.config.args.
+var dashdash = process.argv.indexOf('--');
+
+module.exports = function (config) {
+  config.set({
+    basePath: '../../',
+    frameworks: ['jasmine'],
+
+    // Same order as app/index.html, lazy bundles included.
+    files: [
+      'bower_components/jquery/dist/jquery.js',
+      'bower_components/angular/angular.js',
+      'bower_components/angular-recursion/angular-recursion.min.js',
+      'bower_components/angular-animate/angular-animate.js',
+      'bower_components/angular-aria/angular-aria.js',
+      'bower_components/angular-sanitize/angular-sanitize.js',
+      'bower_components/bootswatch-dist/js/bootstrap.js',
+      'bower_components/angular-ui-router/release/angular-ui-router.js',
+      'bower_components/angular-bootstrap/ui-bootstrap-tpls.js',
+      'bower_components/angular-toastr/dist/angular-toastr.tpls.js',
+      'bower_components/angular-translate/angular-translate.js',
+      'bower_components/angular-translate-loader-static-files/angular-translate-loader-static-files.js',
+      'bower_components/angular-tree-widget/dist/angular-tree-widget.js',
+      'app/scripts/app.js',
+      'app/scripts/workers/EventTransport.js',
+      'app/scripts/{controllers,directives,filters,services}/*.js',
+      {pattern: 'app/scripts/filters/languages/*.js', included: false},
+      {pattern: 'app/views/*.html', included: false},
+      {pattern: 'test/bench/recordings/*.ndjson', included: false},
+      'test/bench/replay.js',
+      'test/bench/*.bench.js'
+    ],
+
+    proxies: {
+      '/views/': '/base/app/views/',
+      '/scripts/filters/languages/': '/base/app/scripts/filters/languages/',
+      '/recordings/': '/base/test/bench/recordings/'
+    },
+
+    browsers: ['ChromeHeadless'],
+    customLaunchers: {
+      ChromeHeadless: {
+        base: 'Chrome',
+        // precise memory figures for performance.memory
+        flags: ['--headless', '--disable-gpu', '--remote-debugging-port=9222', '--enable-precise-memory-info']
+      }
+    },
+
+    client: {
+      captureConsole: true,
+      jasmine: {
+        timeoutInterval: 300000
+      },
+      // e.g. karma start test/bench/karma.conf.js -- --recording=scan.ndjson
+      args: (dashdash === -1) ? [] : process.argv.slice(dashdash + 1)
+    },
+
+    browserNoActivityTimeout: 300000,
+    benchOutput: process.env.BENCH_OUTPUT,
+
+    plugins: ['karma-jasmine', 'karma-chrome-launcher', {'reporter:bench': ['type', BenchReporter]}],
+    reporters: ['progress', 'bench'],
+    singleRun: true
+  });
+};
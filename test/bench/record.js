@@ -0,0 +1,96 @@
+#!/usr/bin/env node
+// Records the events of a running daemon as NDJSON for scan.bench.js.
+//
+//   node test/bench/record.js --host=localhost --port=8888 \
+//        --out=test/bench/recordings/home.ndjson --duration=600
+//
+// Start a scan from the interface once recording has begun; the recording
+// stops on OnDemandCompletedEvent or after --duration seconds.
+
+'use strict';
+
+var fs = require('fs');
+var http = require('http');
+
+var options = {host: 'localhost', port: 8888, out: null, duration: 600};
+process.argv.slice(2).forEach(function (arg) {
+  var match = /^--([a-z]+)=(.*)$/.exec(arg);
+  if (match) {
+    options[match[1]] = match[2];
+  }
+});
+
+if (!options.out) {
+  console.error('usage: record.js --out=<file.ndjson> [--host=h] [--port=p] [--duration=s]');
+  process.exit(1);
+}
+
+var output = fs.createWriteStream(options.out);
+var started = null;
+var count = 0;
+var deadline = Date.now() + Number(options.duration) * 1000;
+
+function get(path, token, callback) {
+  var headers = token ? {'X-Armadito-Token': token} : {};
+  http.get({host: options.host, port: options.port, path: path, headers: headers}, function (response) {
+    var body = '';
+    response.setEncoding('utf8');
+    response.on('data', function (chunk) { body += chunk; });
+    response.on('end', function () { callback(null, response.statusCode, body); });
+  }).on('error', callback);
+}
+
+function finish(token) {
+  output.end();
+  console.log(count + ' events written to ' + options.out);
+  get('/api/unregister', token, function () {});
+}
+
+function poll(token) {
+  if (Date.now() > deadline) {
+    return finish(token);
+  }
+
+  get('/api/event?max_events=256&max_wait=100', token, function (error, status, body) {
+    if (error || status !== 200) {
+      console.error('Error when polling events : ' + (error || status));
+      return finish(token);
+    }
+
+    var events;
+    try {
+      events = JSON.parse(body);
+    }
+    catch (e) {
+      console.error('Error when parsing JSON : ' + e);
+      return poll(token);
+    }
+
+    var now = Date.now();
+    var done = false;
+
+    [].concat(events).forEach(function (event) {
+      if (started === null) {
+        started = now;
+      }
+      output.write(JSON.stringify({t: now - started, event: event}) + '\n');
+      count++;
+      done = done || event.event_type === 'OnDemandCompletedEvent';
+    });
+
+    if (done) {
+      finish(token);
+    }
+    else {
+      poll(token);
+    }
+  });
+}
+
+get('/api/register', null, function (error, status, body) {
+  if (error || status !== 200) {
+    console.error('Error when registering to the daemon : ' + (error || status));
+    process.exit(1);
+  }
+  poll(JSON.parse(body).token);
+});
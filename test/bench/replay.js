@@ -0,0 +1,127 @@
+/***
+
+Copyright (C) 2015, 2016 Teclib'
+
+This file is part of Armadito gui.
+
+Armadito gui is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Armadito gui is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Armadito gui.  If not, see <http://www.gnu.org/licenses/>.
+
+***/
+
+'use strict';
+
+/*
+ * Event streams for the benchmarks: recorded by record.js or synthesized,
+ * as frames {t, event} where t is the delivery time in milliseconds from
+ * the start of the stream. play() delivers them in batches, the way the
+ * event channel does.
+ */
+(function (window) {
+
+  var BenchReplay = {};
+
+  // Recordings are NDJSON, one frame per line.
+  BenchReplay.parse = function (text) {
+    return text.split('\n').filter(function (line) {
+      return line.trim() !== '';
+    }).map(function (line) {
+      return JSON.parse(line);
+    });
+  };
+
+  BenchReplay.load = function (url) {
+    var xmlhttp = new XMLHttpRequest();
+    xmlhttp.open('GET', url, false);
+    xmlhttp.send(null);
+    return BenchReplay.parse(xmlhttp.responseText);
+  };
+
+  // options: rate (events/s), events (total), detections (among events),
+  // every progress event scanning one more file.
+  BenchReplay.synthesize = function (options) {
+    var frames = [];
+    var rate = options.rate || 10000;
+    var detections = options.detections || 0;
+    var events = Math.max(options.events || 0, detections);
+    var detected = 0, malware = 0, scanned = 0;
+
+    for (var i = 0; i < events; i++) {
+      var event;
+
+      // Detections spread evenly over the stream.
+      if (detected < Math.floor((i + 1) * detections / events)) {
+        detected++;
+        var is_malware = (detected % 3 === 0);
+        malware += is_malware ? 1 : 0;
+        event = {
+          event_type: 'DetectionEvent',
+          path: '/home/bench/some/directory/depth/file-' + i + '.bin',
+          scan_status: is_malware ? 'malware' : 'suspicious',
+          scan_action: 'none',
+          module_name: (i % 2) ? 'clamav' : 'moduleH1',
+          module_report: 'Bench.Test.Signature-' + (i % 97)
+        };
+      }
+      else {
+        scanned++;
+        event = {
+          event_type: 'OnDemandProgressEvent',
+          path: '/home/bench/some/directory/depth/file-' + i + '.bin',
+          scanned_count: scanned,
+          malware_count: malware,
+          suspicious_count: detected - malware,
+          skipped_count: 0,
+          progress: Math.floor(100 * i / events),
+          scanned_bytes: scanned * 4096
+        };
+      }
+
+      frames.push({t: i * 1000 / rate, event: event});
+    }
+
+    frames.push({t: events * 1000 / rate, event: {event_type: 'OnDemandCompletedEvent'}});
+    return frames;
+  };
+
+  // Calls deliver(events) with every frame due, every `tick` ms, then done().
+  BenchReplay.play = function (frames, deliver, done, tick) {
+    var start = window.performance.now();
+    var next = 0;
+
+    function step() {
+      var elapsed = window.performance.now() - start;
+      var batch = [];
+
+      while (next < frames.length && frames[next].t <= elapsed) {
+        batch.push(frames[next++].event);
+      }
+
+      if (batch.length) {
+        deliver(batch);
+      }
+
+      if (next < frames.length) {
+        window.setTimeout(step, tick || 10);
+      }
+      else {
+        done();
+      }
+    }
+
+    step();
+  };
+
+  window.BenchReplay = BenchReplay;
+
+})(window);
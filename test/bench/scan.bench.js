@@ -0,0 +1,200 @@
+/***
+
+Copyright (C) 2015, 2016 Teclib'
+
+This file is part of Armadito gui.
+
+Armadito gui is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Armadito gui is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Armadito gui.  If not, see <http://www.gnu.org/licenses/>.
+
+***/
+
+'use strict';
+
+/*
+ * Replays event streams through ApiSession, ScanService, ScanUpdateQueue,
+ * ScanData and a rendered ScanController, and logs one BENCH line per
+ * scenario with digest time, dropped frames, heap growth and the latency
+ * from event delivery to the end of the digest that shows it.
+ */
+describe('Benchmark: scan event replay', function () {
+
+  var SCENARIOS = [
+    {name: 'progress-10k', rate: 10000, events: 50000, detections: 0},
+    {name: 'detections-50k', rate: 10000, events: 100000, detections: 50000}
+  ];
+
+  // --recording=<file> adds a scenario replaying test/bench/recordings/<file>.
+  var args = (window.__karma__ && window.__karma__.config.args) || [];
+  args.forEach(function (arg) {
+    var match = /^--recording=(.+)$/.exec(arg);
+    if (match) {
+      SCENARIOS.push({name: 'recording-' + match[1], recording: match[1]});
+    }
+  });
+
+  angular.module('armaditoBench', ['armaditoApp'])
+    .decorator('ApiSession', ['$delegate', '$q', function ($delegate, $q) {
+      var handlers = [];
+
+      $delegate.request = function () {
+        return $q.when({data: {}});
+      };
+
+      $delegate.subscribe = function (handler) {
+        handlers.push(handler);
+        return function () {
+          handlers.splice(handlers.indexOf(handler), 1);
+        };
+      };
+
+      $delegate.deliver = function (events) {
+        var current = handlers.slice();
+        for (var i = 0; i < events.length; i++) {
+          for (var j = 0; j < current.length; j++) {
+            current[j](events[i]);
+          }
+        }
+      };
+
+      return $delegate;
+    }]);
+
+  function stats(values) {
+    var sorted = values.slice().sort(function (a, b) { return a - b; });
+    var sum = sorted.reduce(function (a, b) { return a + b; }, 0);
+
+    function round(value) {
+      return Math.round(value * 100) / 100;
+    }
+
+    return {
+      count: sorted.length,
+      mean: sorted.length ? round(sum / sorted.length) : 0,
+      p95: sorted.length ? round(sorted[Math.floor(0.95 * (sorted.length - 1))]) : 0,
+      max: sorted.length ? round(sorted[sorted.length - 1]) : 0
+    };
+  }
+
+  function heap() {
+    return window.performance.memory ? window.performance.memory.usedJSHeapSize : null;
+  }
+
+  function run(scenario, done) {
+    var frames = scenario.recording ?
+      window.BenchReplay.load('/recordings/' + scenario.recording) :
+      window.BenchReplay.synthesize(scenario);
+
+    var container = angular.element('<div style="width:900px; height:560px"></div>');
+    angular.element(document.body).append(container);
+
+    var injector = angular.bootstrap(container, ['armaditoBench']);
+    var $rootScope = injector.get('$rootScope');
+
+    injector.get('$templateRequest')('views/Scan.html').then(function (template) {
+      var scope = $rootScope.$new();
+      injector.get('$controller')('ScanController', {$scope: scope});
+      container.html(template);
+      injector.get('$compile')(container.contents())(scope);
+
+      var digests = [], latencies = [], deliveries = [];
+      var dropped = 0, rendered = 0, animating = true;
+
+      var digest = $rootScope.$digest;
+      $rootScope.$digest = function () {
+        var started = window.performance.now();
+        digest.apply(this, arguments);
+        digests.push(window.performance.now() - started);
+      };
+
+      // The controller's listener synchronizes in the next digest: this
+      // measures once that digest is over.
+      injector.get('ScanUpdateQueue').onFlush(function () {
+        $rootScope.$applyAsync(function () {
+          $rootScope.$$postDigest(function () {
+            var now = window.performance.now();
+            deliveries.forEach(function (delivery) {
+              for (var i = 0; i < delivery.count; i++) {
+                latencies.push(now - delivery.time);
+              }
+            });
+            deliveries = [];
+          });
+        });
+      });
+
+      var last_frame = window.performance.now();
+      (function frame() {
+        var now = window.performance.now();
+        var missed = Math.round((now - last_frame) / (1000 / 60)) - 1;
+        dropped += Math.max(0, missed);
+        rendered++;
+        last_frame = now;
+        if (animating) {
+          window.requestAnimationFrame(frame);
+        }
+      })();
+
+      scope.quickScan();
+      scope.startScan();
+      scope.$digest();
+
+      var job = scope.selected_job;
+      var ApiSession = injector.get('ApiSession');
+      var heap_before = heap();
+      var started = window.performance.now();
+
+      window.BenchReplay.play(frames, function (events) {
+        events = events.map(function (event) {
+          return angular.extend({}, event, {scan_id: job.id});
+        });
+        deliveries.push({time: window.performance.now(), count: events.length});
+        ApiSession.deliver(events);
+      }, function () {
+        // Leave the last flush and frames a moment to happen.
+        window.setTimeout(function () {
+          animating = false;
+
+          var heap_after = heap();
+          var result = {
+            name: scenario.name,
+            config: {rate: scenario.rate, events: frames.length, detections: scenario.detections},
+            metrics: {
+              duration_ms: Math.round(window.performance.now() - started),
+              digest_ms: stats(digests),
+              latency_ms: stats(latencies),
+              frames: rendered,
+              dropped_frames: dropped,
+              heap_growth_bytes: (heap_before === null) ? null : heap_after - heap_before,
+              detections_shown: scope.scan_files.length
+            }
+          };
+
+          window.console.log('BENCH ' + JSON.stringify(result));
+
+          scope.$destroy();
+          $rootScope.$destroy();
+          container.remove();
+          done();
+        }, 500);
+      });
+    });
+  }
+
+  SCENARIOS.forEach(function (scenario) {
+    it('replays ' + scenario.name, function (done) {
+      run(scenario, done);
+    });
+  });
+
+});
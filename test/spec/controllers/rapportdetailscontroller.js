@@ -21,24 +21,41 @@ along with Armadito gui.  If not, see <http://www.gnu.org/licenses/>.
 
 'use strict';
 
-describe('Controller: RapportdetailscontrollerCtrl', function () {
+describe('Controller: RapportDetailsController', function () {
 
   // load the controller's module
   beforeEach(module('armaditoApp'));
 
-  var RapportdetailscontrollerCtrl,
-    scope;
+  var scope, viewer, ReportService, $uibModalInstance;
 
   // Initialize the controller and a mock scope
   beforeEach(inject(function ($controller, $rootScope) {
     scope = $rootScope.$new();
-    RapportdetailscontrollerCtrl = $controller('RapportdetailscontrollerCtrl', {
-      $scope: scope
-      // place here mocked dependencies
+    viewer = jasmine.createSpyObj('viewer', ['close']);
+    ReportService = jasmine.createSpyObj('ReportService', ['open', 'download']);
+    ReportService.open.and.returnValue(viewer);
+    $uibModalInstance = jasmine.createSpyObj('$uibModalInstance', ['close', 'dismiss']);
+
+    $controller('RapportDetailsController', {
+      $scope: scope,
+      $uibModalInstance: $uibModalInstance,
+      ReportService: ReportService,
+      report: {report_id: 'scan-1'}
     });
   }));
 
-  it('should attach a list of awesomeThings to the scope', function () {
-    expect(RapportdetailscontrollerCtrl.awesomeThings.length).toBe(3);
+  it('should open the report of the entry', function () {
+    expect(ReportService.open).toHaveBeenCalledWith('scan-1');
+    expect(scope.viewer).toBe(viewer);
+  });
+
+  it('should download the same report', function () {
+    scope.download();
+    expect(ReportService.download).toHaveBeenCalledWith('scan-1');
+  });
+
+  it('should stop reading when the modal goes away', function () {
+    scope.$destroy();
+    expect(viewer.close).toHaveBeenCalled();
   });
 });
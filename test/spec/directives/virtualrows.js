@@ -0,0 +1,107 @@
+'use strict';
+
+describe('Directive: virtualRows', function () {
+
+  // load the directive's module
+  beforeEach(module('armaditoApp'));
+
+  // Same rows as views/Scan.html.
+  var template =
+    '<table><tbody virtual-rows="scan_files" row-height="30" style="display:block; height:300px; overflow:auto">' +
+    '<tr ng-if="virtual.before" ng-style="{height: virtual.before + \'px\'}"></tr>' +
+    '<tr ng-repeat="file in virtual.rows track by file.key" ng-dblclick="openDetection(file.index)">' +
+    '<td ng-class="::file.status_class"></td>' +
+    '<td title="{{::file.module_report}}">{{::file.display_report}}</td>' +
+    '<td title="{{::file.path}}">{{::file.display_path}}</td>' +
+    '</tr>' +
+    '<tr ng-if="virtual.after" ng-style="{height: virtual.after + \'px\'}"></tr>' +
+    '</tbody></table>';
+
+  var scope, element, ScanData;
+
+  function countWatchers(root) {
+    var count = 0;
+    var pending = [root];
+
+    while (pending.length) {
+      var current = pending.pop();
+      count += current.$$watchers ? current.$$watchers.length : 0;
+      for (var child = current.$$childHead; child; child = child.$$nextSibling) {
+        pending.push(child);
+      }
+    }
+    return count;
+  }
+
+  function fill(rows) {
+    var data = ScanData.create();
+    for (var i = 0; i < rows; i++) {
+      data.addScannedFile('/home/user/some/rather/long/path/to/file' + i, i % 2 ? 'malware' : 'suspicious',
+                          'none', 'clamav', 'Report of the module for file ' + i);
+    }
+    return data.data.files;
+  }
+
+  beforeEach(inject(function ($compile, $rootScope, _ScanData_) {
+    ScanData = _ScanData_;
+    scope = $rootScope.$new();
+    element = $compile(template)(scope);
+    angular.element(document.body).append(element);
+  }));
+
+  afterEach(function () {
+    element.remove();
+  });
+
+  it('should not add watchers per row once rows are rendered', function () {
+    scope.scan_files = fill(100);
+    scope.$digest();
+    var small = countWatchers(scope);
+
+    scope.scan_files = fill(10000);
+    scope.$digest();
+    var large = countWatchers(scope);
+
+    // One-time row bindings are gone after the first digest and the
+    // window has the same size whatever the number of detections.
+    expect(large).toBe(small);
+    expect(large).toBeLessThan(100);
+  });
+
+  it('should keep digests cheap with many detections', function () {
+    var watched = 0;
+    var watch = scope.$watch;
+
+    scope.scan_files = fill(100);
+    scope.$digest();
+    var small = countWatchers(scope);
+
+    scope.scan_files = fill(10000);
+    scope.$digest();
+
+    // Counts rather than times, which vary with the machine: a digest
+    // with many detections runs as many watchers as with a few, and
+    // later digests register no new ones.
+    scope.$watch = function () {
+      watched++;
+      return watch.apply(this, arguments);
+    };
+    for (var i = 0; i < 100; i++) {
+      scope.$digest();
+    }
+    scope.$watch = watch;
+
+    expect(countWatchers(scope)).toBe(small);
+    expect(watched).toBe(0);
+  });
+
+  it('should render display fields computed by ScanData', function () {
+    scope.scan_files = fill(1);
+    scope.$digest();
+
+    var cells = element.find('td');
+    expect(angular.element(cells[0]).hasClass('redCircle') || angular.element(cells[0]).hasClass('orangeCircle')).toBe(true);
+    expect(angular.element(cells[2]).text()).toContain('...');
+  });
+
+});
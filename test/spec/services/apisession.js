@@ -0,0 +1,66 @@
+'use strict';
+
+describe('Service: ApiSession', function () {
+
+  // load the service's module
+  beforeEach(module('armaditoApp'));
+
+  // instantiate service
+  var ApiSession, $httpBackend;
+  beforeEach(inject(function (_ApiSession_, _$httpBackend_) {
+    ApiSession = _ApiSession_;
+    $httpBackend = _$httpBackend_;
+    $httpBackend.whenGET(/^scripts\/filters\/languages\//).respond({});
+  }));
+
+  afterEach(function () {
+    $httpBackend.verifyNoOutstandingExpectation();
+    $httpBackend.verifyNoOutstandingRequest();
+  });
+
+  it('should register once and reuse the token', function () {
+    $httpBackend.expectGET('/api/register').respond({token: 'abc'});
+    $httpBackend.expectGET('/api/status', function (headers) {
+      return headers['X-Armadito-Token'] === 'abc';
+    }).respond({});
+    $httpBackend.expectGET('/api/status', function (headers) {
+      return headers['X-Armadito-Token'] === 'abc';
+    }).respond({});
+
+    ApiSession.request({method: 'GET', url: '/api/status'});
+    ApiSession.request({method: 'GET', url: '/api/status'});
+    $httpBackend.flush();
+
+    expect(ApiSession.token).toBe('abc');
+  });
+
+  it('should register again when the token is rejected', function () {
+    $httpBackend.expectGET('/api/register').respond({token: 'old'});
+    $httpBackend.expectGET('/api/status').respond(401);
+    $httpBackend.expectGET('/api/register').respond({token: 'new'});
+    $httpBackend.expectGET('/api/status', function (headers) {
+      return headers['X-Armadito-Token'] === 'new';
+    }).respond({});
+
+    ApiSession.request({method: 'GET', url: '/api/status'});
+    $httpBackend.flush();
+
+    expect(ApiSession.token).toBe('new');
+  });
+
+  it('should keep a session of its own for another daemon', function () {
+    $httpBackend.expectGET('http://host1:8888/api/register').respond({token: 'remote'});
+    $httpBackend.expectGET('http://host1:8888/api/status', function (headers) {
+      return headers['X-Armadito-Token'] === 'remote';
+    }).respond({});
+
+    var session = ApiSession.forHost('http://host1:8888/');
+    session.request({method: 'GET', url: '/api/status'});
+    $httpBackend.flush();
+
+    expect(ApiSession.forHost('http://host1:8888')).toBe(session);
+    expect(session.token).toBe('remote');
+    expect(ApiSession.token).toBe(null);
+  });
+
+});
@@ -6,13 +6,49 @@ describe('Service: BrowseService', function () {
   beforeEach(module('armaditoApp'));
 
   // instantiate service
-  var BrowseService;
-  beforeEach(inject(function (_BrowseService_) {
+  var BrowseService, $httpBackend;
+  beforeEach(inject(function (_BrowseService_, _$httpBackend_) {
     BrowseService = _BrowseService_;
+    $httpBackend = _$httpBackend_;
+    $httpBackend.whenGET(/^scripts\/filters\/languages\//).respond({});
+    $httpBackend.whenGET('/api/register').respond({token: 'abc'});
   }));
 
   it('should do something', function () {
     expect(!!BrowseService).toBe(true);
   });
 
+  it('should serve a fresh listing from its cache', function () {
+    var listing = {path: '/home', content: [{name: 'user', type: 'folder'}]};
+    var pages = [];
+
+    $httpBackend.expectGET(/^\/api\/browse\?/).respond(listing);
+
+    BrowseService.browse('/home').then(function (page) { pages.push(page); });
+    $httpBackend.flush();
+    BrowseService.browse('/home').then(function (page) { pages.push(page); });
+    $httpBackend.verifyNoOutstandingRequest();
+
+    expect(pages.length).toBe(2);
+    expect(pages[1].next_offset).toBe(null);
+  });
+
+  it('should revalidate a stale listing with its ETag', function () {
+    var listing = {path: '/home', content: []};
+    var page;
+
+    $httpBackend.expectGET(/^\/api\/browse\?/).respond(200, listing, {'ETag': '"v1"'});
+    BrowseService.browse('/home');
+    $httpBackend.flush();
+
+    BrowseService.max_age = 0;
+    $httpBackend.expectGET(/^\/api\/browse\?/, function (headers) {
+      return headers['If-None-Match'] === '"v1"';
+    }).respond(304, '');
+    BrowseService.browse('/home').then(function (p) { page = p; });
+    $httpBackend.flush();
+
+    expect(page).toEqual({path: '/home', content: [], next_offset: null});
+  });
+
 });
@@ -0,0 +1,145 @@
+'use strict';
+
+describe('Service: DetectionStore', function () {
+
+  // load the service's module
+  beforeEach(module('armaditoApp'));
+
+  // instantiate service
+  var DetectionStore;
+  beforeEach(inject(function (_DetectionStore_) {
+    DetectionStore = _DetectionStore_;
+  }));
+
+  function detection(i) {
+    return {
+      path: '/home/user/file' + i,
+      scan_status: 'malware',
+      scan_action: 'none',
+      module_name: 'clamav',
+      module_report: 'Eicar-Test-Signature'
+    };
+  }
+
+  it('should intern repeated strings', function () {
+    var store = DetectionStore.create();
+
+    store.push(detection(0));
+    store.push(detection(1));
+
+    expect(store.length).toBe(2);
+    expect(store.strings.length).toBe(3);
+    expect(store.slice(1, 2)[0].path).toBe('/home/user/file1');
+    expect(store.slice(1, 2)[0].module_name).toBe('clamav');
+  });
+
+  it('should keep resident rows under its memory cap', function () {
+    var store = DetectionStore.create({max_bytes: 1024});
+
+    for (var i = 0; i < 100; i++) {
+      store.push(detection(i));
+    }
+
+    expect(store.length).toBe(100);
+    expect(store.resident_bytes).not.toBeGreaterThan(1024);
+    expect(store.offset).toBeGreaterThan(0);
+    expect(store.slice(99, 100)[0].path).toBe('/home/user/file99');
+  });
+
+  it('should keep rows in memory when IndexedDB cannot be opened', inject(function ($rootScope) {
+    var request = {error: 'denied'};
+    var store = DetectionStore.create({max_bytes: 1024});
+    var i;
+
+    spyOn(window.indexedDB, 'open').and.returnValue(request);
+    spyOn(console, 'error');
+    spyOn(console, 'warn');
+
+    for (i = 0; i < 20; i++) {
+      store.push(detection(i));
+    }
+    request.onerror();
+    $rootScope.$digest();
+
+    for (i = 20; i < 100; i++) {
+      store.push(detection(i));
+    }
+
+    var rows = store.slice(0, 100);
+    expect(rows.filter(function (row) { return row.pending; }).length).toBe(0);
+    expect(rows[0].path).toBe('/home/user/file0');
+    expect(rows[99].path).toBe('/home/user/file99');
+  }));
+
+  it('should keep the most recently read pages', function () {
+    var store = DetectionStore.create();
+
+    [1, 2, 3, 1].forEach(function (page) {
+      store.touchPage(page);
+    });
+
+    expect(store.page_order).toEqual([2, 3, 1]);
+  });
+
+  function push(store, path, status, module) {
+    store.push({path: path, scan_status: status, scan_action: 'none', module_name: module, module_report: ''});
+  }
+
+  function indexes(view) {
+    return view.slice(0, view.length).map(function (row) {
+      return row.group ? row.label + ':' + row.count : row.index;
+    });
+  }
+
+  it('should filter on values and path prefixes', function () {
+    var store = DetectionStore.create();
+
+    push(store, '/srv/www/a', 'malware', 'clamav');
+    push(store, '/srv/www2/b', 'malware', 'clamav');
+    push(store, '/srv/www/c/d', 'suspicious', 'clamav');
+    push(store, '/srv/www/e', 'malware', 'moduleH1');
+
+    expect(indexes(store.view({prefix: '/srv/www/', module_name: 'clamav'}))).toEqual([0, 2]);
+    expect(indexes(store.view({scan_status: 'malware'}))).toEqual([0, 1, 3]);
+    expect(indexes(store.view({module_name: 'unknown'}))).toEqual([]);
+  });
+
+  it('should keep views up to date as rows come in', function () {
+    var store = DetectionStore.create();
+    var view = store.view({module_name: 'moduleH1', sort: 'scan_status'});
+
+    push(store, '/a', 'suspicious', 'clamav');
+    expect(view.length).toBe(0);
+
+    push(store, '/b', 'suspicious', 'moduleH1');
+    push(store, '/c', 'malware', 'moduleH1');
+    expect(indexes(view)).toEqual([2, 1]);
+
+    push(store, '/d', 'malware', 'moduleH1');
+    expect(indexes(view)).toEqual([2, 3, 1]);
+  });
+
+  it('should sort in both directions and group by value', function () {
+    var store = DetectionStore.create();
+
+    push(store, '/a', 'suspicious', 'clamav');
+    push(store, '/b', 'malware', 'moduleH1');
+    push(store, '/c', 'malware', 'clamav');
+
+    expect(indexes(store.view({sort: 'module_name', desc: true}))).toEqual([1, 2, 0]);
+    expect(indexes(store.view({group: 'scan_status'}))).toEqual(['malware:2', 1, 2, 'suspicious:1', 0]);
+    expect(store.values('module_name')).toEqual(['clamav', 'moduleH1']);
+  });
+
+  it('should index rows once they are spilled', function () {
+    var store = DetectionStore.create({max_bytes: 1024});
+
+    for (var i = 0; i < 100; i++) {
+      push(store, '/home/user/file' + i, (i % 10) ? 'malware' : 'suspicious', 'clamav');
+    }
+
+    expect(store.offset).toBeGreaterThan(0);
+    expect(store.view({scan_status: 'suspicious'}).length).toBe(10);
+  });
+
+});
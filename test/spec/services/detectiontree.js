@@ -0,0 +1,78 @@
+'use strict';
+
+describe('Service: DetectionTree', function () {
+
+  // load the service's module
+  beforeEach(module('armaditoApp'));
+
+  // instantiate service
+  var DetectionStore, DetectionTree;
+  beforeEach(inject(function (_DetectionStore_, _DetectionTree_) {
+    DetectionStore = _DetectionStore_;
+    DetectionTree = _DetectionTree_;
+  }));
+
+  function push(store, path) {
+    store.push({path: path, scan_status: 'malware', scan_action: 'none', module_name: 'clamav', module_report: ''});
+  }
+
+  it('should count detections per directory', function () {
+    var store = DetectionStore.create();
+    var tree = DetectionTree.create(store);
+
+    push(store, '/home/user/a/file0');
+    push(store, '/home/user/a/file1');
+    push(store, '/home/user/b/file2');
+
+    var root = tree.refresh()[0];
+
+    expect(root.name).toBe('/ (3)');
+
+    // Single subfolders are opened down to the first fork.
+    var user = root.children[0].children[0];
+    expect(user.full_path).toBe('/home/user');
+    expect(user.expanded).toBe(true);
+    expect(user.children.map(function (node) { return node.name; })).toEqual(['a (2)', 'b (1)']);
+  });
+
+  it('should only create nodes for expanded folders', function () {
+    var store = DetectionStore.create();
+    var tree = DetectionTree.create(store);
+
+    push(store, '/home/user/a/deep/file0');
+    push(store, '/home/user/b/file1');
+    tree.refresh();
+
+    var a = tree.nodes[0].children[0].children[0].children[0];
+    expect(a.full_path).toBe('/home/user/a');
+    expect(a.children.length).toBe(0);
+
+    tree.expand(a);
+    expect(a.children[0].full_path).toBe('/home/user/a/deep');
+  });
+
+  it('should update counts incrementally', function () {
+    var store = DetectionStore.create();
+    var tree = DetectionTree.create(store);
+
+    push(store, '/tmp/file0');
+    tree.refresh();
+    push(store, '/tmp/file1');
+    push(store, '/var/file2');
+    tree.refresh();
+
+    var root = tree.nodes[0];
+    expect(root.name).toBe('/ (3)');
+    expect(root.children.map(function (node) { return node.name; })).toEqual(['tmp (2)', 'var (1)']);
+  });
+
+  it('should keep windows paths', function () {
+    var store = DetectionStore.create();
+    var tree = DetectionTree.create(store);
+
+    push(store, 'C:\\Users\\file0');
+    tree.refresh();
+
+    expect(tree.nodes[0].children[0].children[0].full_path).toBe('C:\\Users');
+  });
+});
@@ -0,0 +1,231 @@
+'use strict';
+
+describe('Service: EventChannel', function () {
+
+  // load the service's module
+  beforeEach(module('armaditoApp'));
+
+  // instantiate service
+  var EventChannel;
+  beforeEach(inject(function (_EventChannel_) {
+    EventChannel = _EventChannel_;
+    // The UI thread transport, see the worker tests below.
+    EventChannel.worker_supported = false;
+  }));
+
+  it('should long-poll when streaming is not supported', function () {
+    spyOn(XMLHttpRequest.prototype, 'open');
+    spyOn(XMLHttpRequest.prototype, 'send');
+
+    EventChannel.streaming_supported = false;
+    var channel = EventChannel.open('token', function () {});
+
+    expect(XMLHttpRequest.prototype.open).toHaveBeenCalledWith('GET', EventChannel.eventUrl(), true);
+    channel.close();
+    expect(channel.closed).toBe(true);
+  });
+
+  it('should not dispatch events once closed', function () {
+    var received = [];
+
+    EventChannel.streaming_supported = false;
+    spyOn(XMLHttpRequest.prototype, 'send');
+    var channel = EventChannel.open('token', function (e) { received.push(e); });
+
+    channel.dispatch([{event_type: 'DetectionEvent'}, {event_type: 'DetectionEvent'}]);
+    channel.close();
+    channel.dispatch([{event_type: 'DetectionEvent'}]);
+
+    expect(received.length).toBe(2);
+  });
+
+  it('should drop replayed events and report gaps', function () {
+    var received = [], gaps = [];
+
+    EventChannel.streaming_supported = false;
+    spyOn(XMLHttpRequest.prototype, 'send');
+    var channel = EventChannel.open('token', function (e) { received.push(e.seq); }, null,
+                                    function (first, last) { gaps.push([first, last]); });
+
+    channel.dispatch([{seq: 1}, {seq: 2}]);
+    channel.dispatch([{seq: 2}, {seq: 5}]);
+    channel.close();
+
+    expect(received).toEqual([1, 2, 5]);
+    expect(gaps).toEqual([[3, 4]]);
+    expect(channel.last_seq).toBe(5);
+  });
+
+  it('should keep an idle stream open while heartbeats come in', function () {
+    var sources = [];
+    var EventSource = window.EventSource;
+
+    window.EventSource = function (url) {
+      this.url = url;
+      this.listeners = {};
+      this.close = jasmine.createSpy('close');
+      this.addEventListener = function (type, listener) { this.listeners[type] = listener; };
+      sources.push(this);
+    };
+
+    jasmine.clock().install();
+    try {
+      EventChannel.streaming_supported = true;
+      var channel = EventChannel.open('token', function () {});
+
+      expect(sources[0].url).toContain('&heartbeat=' + Math.floor(EventChannel.stall_timeout / 3));
+      sources[0].onopen();
+
+      for (var i = 0; i < 5; i++) {
+        jasmine.clock().tick(EventChannel.stall_timeout - 1);
+        sources[0].listeners.heartbeat({});
+      }
+      expect(sources[0].close).not.toHaveBeenCalled();
+
+      jasmine.clock().tick(EventChannel.stall_timeout);
+      expect(sources[0].close).toHaveBeenCalled();
+      channel.close();
+    }
+    finally {
+      jasmine.clock().uninstall();
+      window.EventSource = EventSource;
+    }
+  });
+
+  it('should check the token with a long-poll when a stream fails to reopen', function () {
+    var sources = [], requests = [];
+    var EventSource = window.EventSource, XHR = window.XMLHttpRequest;
+
+    window.EventSource = function (url) {
+      this.url = url;
+      this.readyState = 0;
+      this.close = jasmine.createSpy('close');
+      this.addEventListener = angular.noop;
+      sources.push(this);
+    };
+    window.XMLHttpRequest = function () {
+      this.open = this.setRequestHeader = this.abort = angular.noop;
+      this.send = function () { requests.push(this); };
+    };
+
+    jasmine.clock().install();
+    try {
+      var auth_error = jasmine.createSpy('onAuthError');
+      spyOn(console, 'warn');
+      EventChannel.streaming_supported = true;
+      var channel = EventChannel.open('token', function () {}, auth_error);
+
+      sources[0].onopen();
+      sources[0].readyState = 2;
+      sources[0].onerror();
+      jasmine.clock().tick(EventChannel.backoff.max);
+
+      expect(sources.length).toBe(2);
+      sources[1].onerror();
+
+      expect(EventChannel.streaming_supported).toBe(true);
+      expect(requests.length).toBe(1);
+      requests[0].readyState = 4;
+      requests[0].status = 401;
+      requests[0].onreadystatechange();
+
+      expect(auth_error).toHaveBeenCalled();
+      expect(channel.closed).toBe(true);
+    }
+    finally {
+      jasmine.clock().uninstall();
+      window.EventSource = EventSource;
+      window.XMLHttpRequest = XHR;
+    }
+  });
+
+  it('should resume after the last sequence number', function () {
+    expect(EventChannel.eventUrl()).not.toContain('since=');
+    expect(EventChannel.eventUrl(42)).toContain('&since=42');
+  });
+
+  it('should back off exponentially up to the maximum', function () {
+    for (var attempt = 0; attempt < 20; attempt++) {
+      var delay = EventChannel.retryDelay(attempt);
+      var ceiling = Math.min(EventChannel.backoff.max, EventChannel.backoff.initial * Math.pow(2, attempt));
+      expect(delay).toBeGreaterThan(ceiling / 2 - 1);
+      expect(delay).toBeLessThan(ceiling + 1);
+    }
+  });
+
+  it('should parse single events and batches alike', function () {
+    expect(EventChannel.parseEvents('{"event_type":"StatusEvent"}').length).toBe(1);
+    expect(EventChannel.parseEvents('[{"event_type":"DetectionEvent"},{"event_type":"DetectionEvent"}]').length).toBe(2);
+    expect(EventChannel.parseEvents('not json').length).toBe(0);
+  });
+
+  describe('in a worker', function () {
+    var worker, Worker = window.Worker;
+
+    afterEach(function () {
+      window.Worker = Worker;
+    });
+
+    beforeEach(inject(function ($window) {
+      worker = null;
+      $window.Worker = function (url) {
+        worker = this;
+        this.url = url;
+        this.messages = [];
+        this.postMessage = function (message) { this.messages.push(message); };
+        this.terminate = jasmine.createSpy('terminate');
+      };
+      EventChannel.worker_supported = true;
+    }));
+
+    it('should open the channel in the worker', function () {
+      EventChannel.open('token', function () {});
+
+      expect(worker.url).toBe(EventChannel.worker_url);
+      expect(worker.messages[0].open.token).toBe('token');
+      expect(worker.messages[0].open.settings.batch).toEqual(EventChannel.batch);
+    });
+
+    it('should dispatch the batches of the worker and its gaps', function () {
+      var received = [], gaps = [];
+      var channel = EventChannel.open('token', function (e) { received.push(e.seq); }, null,
+                                      function (first, last) { gaps.push([first, last]); });
+
+      worker.onmessage({data: {events: [{seq: 1}, {seq: 2}]}});
+      worker.onmessage({data: {gap: [3, 4]}});
+      worker.onmessage({data: {events: [{seq: 5}]}});
+      channel.close();
+      worker.onmessage({data: {events: [{seq: 6}]}});
+
+      expect(received).toEqual([1, 2, 5]);
+      expect(gaps).toEqual([[3, 4]]);
+      expect(worker.terminate).toHaveBeenCalled();
+    });
+
+    it('should remember a stream refused in the worker', function () {
+      EventChannel.streaming_supported = true;
+      EventChannel.open('token', function () {});
+      worker.onmessage({data: {streaming_supported: false}});
+
+      expect(EventChannel.streaming_supported).toBe(false);
+      EventChannel.open('token', function () {});
+      expect(worker.messages[0].open.settings.streaming_supported).toBe(false);
+    });
+
+    it('should fall back to the UI thread when the worker fails', function () {
+      spyOn(console, 'warn');
+      spyOn(XMLHttpRequest.prototype, 'open');
+      spyOn(XMLHttpRequest.prototype, 'send');
+      EventChannel.streaming_supported = false;
+
+      var channel = EventChannel.open('token', function () {});
+      worker.onerror({message: 'not found'});
+
+      expect(EventChannel.worker_supported).toBe(false);
+      expect(XMLHttpRequest.prototype.open).toHaveBeenCalledWith('GET', EventChannel.eventUrl(), true);
+      channel.close();
+      expect(channel.fallback.closed).toBe(true);
+    });
+  });
+
+});
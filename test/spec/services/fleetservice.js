@@ -0,0 +1,164 @@
+'use strict';
+
+describe('Service: FleetService', function () {
+
+  // load the service's module
+  beforeEach(module('armaditoApp'));
+
+  // instantiate service
+  var FleetService, ApiSession, $q, $rootScope, $timeout, sessions;
+  beforeEach(inject(function (_FleetService_, _ApiSession_, _$q_, _$rootScope_, _$timeout_) {
+    FleetService = _FleetService_;
+    ApiSession = _ApiSession_;
+    $q = _$q_;
+    $rootScope = _$rootScope_;
+    $timeout = _$timeout_;
+    sessions = {};
+
+    window.localStorage.removeItem('armadito.fleet_hosts');
+
+    // Requests stay pending until answered by the test.
+    spyOn(ApiSession, 'forHost').and.callFake(function (url) {
+      var session = {
+        requests: [],
+        handler: null,
+        register: function () { return $q.when('token'); },
+        subscribe: function (handler) {
+          session.handler = handler;
+          return function () { session.handler = null; };
+        },
+        request: function (config) {
+          var deferred = $q.defer();
+          session.requests.push({config: config, deferred: deferred});
+          return deferred.promise;
+        }
+      };
+      sessions[url] = session;
+      return session;
+    });
+  }));
+
+  afterEach(function () {
+    window.localStorage.removeItem('armadito.fleet_hosts');
+  });
+
+  function answer(session, data) {
+    session.requests.shift().deferred.resolve({data: data});
+    $rootScope.$digest();
+  }
+
+  it('should connect at most max_concurrent hosts at once', function () {
+    FleetService.max_concurrent = 2;
+
+    FleetService.addHost('host1:8888');
+    FleetService.addHost('host2:8888');
+    FleetService.addHost('host3:8888');
+    $rootScope.$digest();
+
+    expect(sessions['http://host1:8888'].requests.length).toBe(1);
+    expect(sessions['http://host2:8888'].requests.length).toBe(1);
+    expect(sessions['http://host3:8888'].requests.length).toBe(0);
+
+    answer(sessions['http://host1:8888'], {});
+    answer(sessions['http://host1:8888'], []);
+
+    expect(FleetService.hosts[0].state).toBe('online');
+    expect(sessions['http://host3:8888'].requests[0].config.url).toBe('/api/status');
+  });
+
+  it('should roll the status of hosts up by module', function () {
+    FleetService.addHost('host1');
+    FleetService.addHost('host2');
+    $rootScope.$digest();
+
+    sessions['http://host1'].handler({event_type: 'StatusEvent', global_status: 'late',
+      modules: [{name: 'clamav', mod_status: 'late'}]});
+    sessions['http://host2'].handler({event_type: 'StatusEvent', global_status: 'up-to-date',
+      modules: [{name: 'clamav', mod_status: 'up-to-date'}]});
+    sessions['http://host2'].handler({event_type: 'StatusDeltaEvent', global_status: 'late',
+      modules: [{name: 'clamav', mod_status: 'late'}]});
+
+    var rollup = FleetService.rollup();
+
+    expect(rollup.statuses).toEqual({late: 2});
+    expect(rollup.modules).toEqual([{name: 'clamav', statuses: {late: 2}}]);
+  });
+
+  it('should ask a host sending too many events for a snapshot instead', function () {
+    FleetService.max_host_events = 2;
+    FleetService.addHost('host1');
+    $rootScope.$digest();
+
+    var session = sessions['http://host1'];
+    answer(session, {});
+    answer(session, [{scan_id: 's1', scanned_count: 10, malware_count: 1, progress: 5}]);
+    answer(session, {});
+
+    for (var i = 0; i < 5; i++) {
+      session.handler({event_type: 'OnDemandProgressEvent', scan_id: 's1', scanned_count: 20 + i, progress: 10});
+    }
+
+    expect(FleetService.rollup().scans.scanned_count).toBe(21);
+
+    $timeout.flush(FleetService.flush_interval);
+
+    expect(session.requests[0].config.url).toBe('/api/status');
+  });
+
+  it('should put a host offline when its channel is lost', function () {
+    FleetService.addHost('host1');
+    $rootScope.$digest();
+
+    var session = sessions['http://host1'];
+    answer(session, {});
+    answer(session, []);
+    expect(FleetService.hosts[0].state).toBe('online');
+
+    session.handler({event_type: 'ChannelStateEvent', connected: false});
+
+    expect(FleetService.hosts[0].state).toBe('offline');
+    expect(session.handler).toBe(null);
+  });
+
+  it('should drop the scans a resync no longer finds running', function () {
+    FleetService.addHost('host1');
+    $rootScope.$digest();
+
+    var session = sessions['http://host1'];
+    answer(session, {});
+    answer(session, [{scan_id: 's1'}, {scan_id: 's2'}]);
+    answer(session, {});
+    answer(session, {});
+    expect(FleetService.rollup().scans.running).toBe(2);
+
+    session.handler({event_type: 'EventGapEvent', first_seq: 3, last_seq: 9});
+    $timeout.flush(FleetService.flush_interval);
+    answer(session, {});
+    answer(session, [{scan_id: 's2'}]);
+
+    expect(Object.keys(FleetService.hosts[0].scans)).toEqual(['s2']);
+  });
+
+  it('should poll the hosts beyond max_channels', function () {
+    FleetService.max_channels = 1;
+    FleetService.addHost('host1');
+    FleetService.addHost('host2');
+    $rootScope.$digest();
+
+    var session = sessions['http://host2'];
+    answer(session, {});
+    expect(session.requests[0].config.url).toBe('/api/event');
+    session.requests.shift().deferred.resolve({data: [{event_type: 'StatusEvent', global_status: 'late', modules: []}]});
+    $rootScope.$digest();
+    answer(session, []);
+
+    expect(session.handler).toBe(null);
+    expect(FleetService.hosts[1].state).toBe('online');
+    expect(FleetService.hosts[1].status.global_status).toBe('late');
+
+    FleetService.removeHost(FleetService.hosts[0]);
+    $timeout.flush(FleetService.poll_interval);
+
+    expect(session.handler).not.toBe(null);
+  });
+});
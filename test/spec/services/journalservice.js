@@ -0,0 +1,62 @@
+'use strict';
+
+describe('Service: JournalService', function () {
+
+  // load the service's module
+  beforeEach(module('armaditoApp'));
+
+  // instantiate service
+  var JournalService, $httpBackend;
+  beforeEach(inject(function (_JournalService_, _$httpBackend_) {
+    JournalService = _JournalService_;
+    $httpBackend = _$httpBackend_;
+    $httpBackend.whenGET(/^scripts\/filters\/languages\//).respond({});
+    $httpBackend.whenGET('/api/register').respond({token: 'abc'});
+  }));
+
+  afterEach(function () {
+    $httpBackend.verifyNoOutstandingExpectation();
+    $httpBackend.verifyNoOutstandingRequest();
+  });
+
+  it('should only send the filters that are set', function () {
+    var params = JournalService.toParams({q: 'home', type: '', user: 'root'}, 'c1');
+
+    expect(params).toEqual({limit: JournalService.page_size, cursor: 'c1', q: 'home', user: 'root'});
+  });
+
+  it('should follow the cursor page by page', function () {
+    var query = JournalService.query({type: 'scan'});
+
+    $httpBackend.expectGET('/api/journal?limit=100&type=scan')
+      .respond({entries: [{type: 'scan'}], next_cursor: 'c1'});
+    query.reload();
+    $httpBackend.flush();
+
+    $httpBackend.expectGET('/api/journal?cursor=c1&limit=100&type=scan')
+      .respond({entries: [{type: 'scan'}]});
+    query.more();
+    $httpBackend.flush();
+
+    expect(query.entries.length).toBe(2);
+    expect(query.done).toBe(true);
+
+    // Same type, time and path: still tracked apart.
+    expect(query.entries[0].key).not.toEqual(query.entries[1].key);
+  });
+
+  it('should ignore pages of a previous search', function () {
+    var query = JournalService.query({q: 'old'});
+
+    $httpBackend.expectGET('/api/journal?limit=100&q=old').respond({entries: [{path: 'old'}]});
+    $httpBackend.expectGET('/api/journal?limit=100&q=new').respond({entries: [{path: 'new'}]});
+    query.reload();
+    query.filters.q = 'new';
+    query.reload();
+    $httpBackend.flush();
+
+    expect(query.entries.length).toBe(1);
+    expect(query.entries[0].path).toBe('new');
+  });
+
+});
@@ -0,0 +1,112 @@
+'use strict';
+
+describe('Service: QuarantineService', function () {
+
+  // load the service's module
+  beforeEach(module('armaditoApp'));
+
+  // instantiate service
+  var QuarantineService, ApiSession, $httpBackend, $timeout;
+  beforeEach(inject(function (_QuarantineService_, _ApiSession_, _$httpBackend_, _$timeout_) {
+    QuarantineService = _QuarantineService_;
+    $timeout = _$timeout_;
+    ApiSession = _ApiSession_;
+    $httpBackend = _$httpBackend_;
+    $httpBackend.whenGET(/^scripts\/filters\/languages\//).respond({});
+    $httpBackend.whenGET('/api/register').respond({token: 'abc'});
+    spyOn(ApiSession, 'subscribe').and.returnValue(angular.noop);
+  }));
+
+  afterEach(function () {
+    $httpBackend.verifyNoOutstandingExpectation();
+    $httpBackend.verifyNoOutstandingRequest();
+  });
+
+  it('should send a batch of ids with its operation id', function () {
+    var operation;
+
+    $httpBackend.expectPOST('/api/quarantine/restore', function (data) {
+      data = JSON.parse(data);
+      return data.op_id === operation.id && data.ids.length === 3 && data.filter === undefined;
+    }).respond({});
+
+    operation = QuarantineService.apply('restore', {ids: [1, 2, 3]});
+    $httpBackend.flush();
+
+    expect(operation.total).toBe(3);
+    expect(ApiSession.subscribe).toHaveBeenCalled();
+  });
+
+  it('should send a filter rather than ids for the whole quarantine', function () {
+    $httpBackend.expectPOST('/api/quarantine/delete', function (data) {
+      data = JSON.parse(data);
+      return data.ids === undefined && angular.equals(data.filter, {});
+    }).respond({});
+
+    QuarantineService.apply('delete', {filter: {}});
+    $httpBackend.flush();
+  });
+
+  it('should follow progress events until completion', function () {
+    $httpBackend.expectPOST('/api/quarantine/delete').respond({});
+    var operation = QuarantineService.apply('delete', {filter: {q: 'tmp'}});
+    $httpBackend.flush();
+
+    QuarantineService.handleEvent({event_type: 'QuarantineProgressEvent', op_id: operation.id, done: 10, total: 40});
+    expect(operation.done).toBe(10);
+    expect(operation.total).toBe(40);
+
+    QuarantineService.handleEvent({event_type: 'QuarantineCompletedEvent', op_id: operation.id, done: 38, failed: 2});
+    expect(operation.running).toBe(false);
+    expect(operation.failed).toBe(2);
+    expect(QuarantineService.operations[operation.id]).toBeUndefined();
+  });
+
+  it('should mark the whole selection failed when the daemon refuses', function () {
+    spyOn(console, 'error');
+    $httpBackend.expectPOST('/api/quarantine/restore').respond(500, {});
+    var operation = QuarantineService.apply('restore', {ids: [1, 2]});
+    $httpBackend.flush();
+
+    expect(operation.running).toBe(false);
+    expect(operation.error).toBe(500);
+    expect(operation.failed).toBe(2);
+  });
+
+  it('should ask for the state of operations when events were lost', function () {
+    var ended = null;
+
+    $httpBackend.expectPOST('/api/quarantine/restore').respond({});
+    var operation = QuarantineService.apply('restore', {ids: [1, 2, 3]});
+    operation.promise.then(function (o) { ended = o; });
+    $httpBackend.flush();
+
+    $httpBackend.expectGET('/api/quarantine/operation?op_id=' + operation.id)
+      .respond({state: 'completed', done: 3, failed: 0});
+    QuarantineService.handleEvent({event_type: 'EventGapEvent', first_seq: 4, last_seq: 9});
+    $httpBackend.flush();
+
+    expect(operation.running).toBe(false);
+    expect(ended).toBe(operation);
+  });
+
+  it('should give up an operation that makes no progress', function () {
+    var rejected = null;
+
+    spyOn(console, 'error');
+    $httpBackend.expectPOST('/api/quarantine/delete').respond({});
+    var operation = QuarantineService.apply('delete', {ids: [1, 2]});
+    operation.promise.catch(function (o) { rejected = o; });
+    $httpBackend.flush();
+
+    $httpBackend.expectGET(/^\/api\/quarantine\/operation\?/).respond({state: 'running', done: 0, total: 2});
+    $timeout.flush(QuarantineService.timeout);
+    $httpBackend.flush();
+
+    expect(operation.running).toBe(false);
+    expect(operation.error).toBe('timeout');
+    expect(operation.failed).toBe(2);
+    expect(rejected).toBe(operation);
+  });
+
+});
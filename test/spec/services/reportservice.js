@@ -0,0 +1,103 @@
+'use strict';
+
+describe('Service: ReportService', function () {
+
+  var workers, Worker = window.Worker;
+
+  afterEach(function () {
+    window.Worker = Worker;
+  });
+
+  function FakeWorker(url) {
+    this.url = url;
+    this.messages = [];
+    this.terminated = false;
+    workers.push(this);
+  }
+  FakeWorker.prototype.postMessage = function (message) {
+    this.messages.push(message);
+  };
+  FakeWorker.prototype.terminate = function () {
+    this.terminated = true;
+  };
+
+  // load the service's module
+  beforeEach(module('armaditoApp', function ($provide) {
+    workers = [];
+    $provide.decorator('$window', function ($delegate) {
+      $delegate.Worker = FakeWorker;
+      return $delegate;
+    });
+  }));
+
+  // instantiate service
+  var ReportService, $httpBackend;
+  beforeEach(inject(function (_ReportService_, _$httpBackend_) {
+    ReportService = _ReportService_;
+    $httpBackend = _$httpBackend_;
+    $httpBackend.whenGET(/^scripts\/filters\/languages\//).respond({});
+    $httpBackend.whenGET('/api/register').respond({token: 'abc'});
+  }));
+
+  it('should start the worker once registered', function () {
+    ReportService.open('scan-1');
+    expect(workers.length).toBe(0);
+
+    $httpBackend.flush();
+
+    expect(workers.length).toBe(1);
+    expect(workers[0].messages[0].url).toBe('/api/report/scan-1');
+    expect(workers[0].messages[0].token).toBe('abc');
+  });
+
+  it('should fill the report batch by batch', function () {
+    var viewer = ReportService.open('scan-1');
+    $httpBackend.flush();
+
+    viewer.handleMessage({header: {report: 1, path: '/home', type: 'scan_view.Full_scan',
+                                   scanned_count: 10, suspicious_count: 1, malware_count: 2}});
+    viewer.handleMessage({rows: [{path: '/home/a', scan_status: 'malware'},
+                                 {path: '/home/b', scan_status: 'suspicious'}], loaded: 2});
+    viewer.handleMessage({rows: [{path: '/home/c', scan_status: 'malware'}], loaded: 3});
+
+    expect(viewer.data.data.path_to_scan).toBe('/home');
+    expect(viewer.data.data.malware_count).toBe(2);
+    expect(viewer.data.data.files.length).toBe(3);
+    expect(viewer.data.data.files.slice(2, 3)[0].status_class).toBe('redCircle');
+    expect(viewer.loaded).toBe(3);
+    expect(viewer.done).toBe(false);
+
+    viewer.handleMessage({done: true, loaded: 3});
+    expect(viewer.done).toBe(true);
+    expect(workers[0].terminated).toBe(true);
+  });
+
+  it('should not start the worker when closed while registering', function () {
+    var viewer = ReportService.open('scan-1');
+
+    viewer.close();
+    $httpBackend.flush();
+
+    expect(workers.length).toBe(0);
+    expect(viewer.worker).toBe(null);
+  });
+
+  it('should stop reading when closed', function () {
+    var viewer = ReportService.open('scan-1');
+    $httpBackend.flush();
+
+    viewer.close();
+    expect(workers[0].terminated).toBe(true);
+    expect(viewer.data.data.files.length).toBe(0);
+  });
+
+  it('should keep the error of a report that cannot be read', function () {
+    spyOn(console, 'error');
+    var viewer = ReportService.open('scan-1');
+    $httpBackend.flush();
+
+    viewer.handleMessage({error: 'HTTP status 404'});
+    expect(viewer.error).toBe('HTTP status 404');
+    expect(workers[0].terminated).toBe(true);
+  });
+});
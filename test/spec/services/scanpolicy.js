@@ -0,0 +1,89 @@
+'use strict';
+
+describe('Service: ScanPolicy', function () {
+
+  // load the service's module
+  beforeEach(module('armaditoApp'));
+
+  // instantiate service
+  var ScanPolicy, ScanProfiles, $httpBackend;
+  beforeEach(inject(function (_ScanPolicy_, _ScanProfiles_, _$httpBackend_) {
+    ScanPolicy = _ScanPolicy_;
+    ScanProfiles = _ScanProfiles_;
+    $httpBackend = _$httpBackend_;
+    $httpBackend.whenGET(/^scripts\/filters\/languages\//).respond({});
+    $httpBackend.whenGET('/api/register').respond({token: 'abc'});
+  }));
+
+  afterEach(function () {
+    $httpBackend.verifyNoOutstandingExpectation();
+    $httpBackend.verifyNoOutstandingRequest();
+  });
+
+  it('should fill in what an older daemon does not send', function () {
+    $httpBackend.expectGET('/api/scan/policy').respond({throttle: {cpu_priority: 'low'}});
+
+    ScanPolicy.load();
+    $httpBackend.flush();
+
+    expect(ScanPolicy.policy.throttle.cpu_priority).toBe('low');
+    expect(ScanPolicy.policy.throttle.io_priority).toBe('normal');
+    expect(ScanPolicy.policy.schedules).toEqual([]);
+  });
+
+  it('should send no limit for empty values and the content of profiles', function () {
+    spyOn(ScanProfiles, 'find').and.returnValue({name: 'fast', heuristicMode: false, scanArchive: false, exclusions: ['*.iso']});
+
+    var request = ScanPolicy.toRequest({
+      throttle: {cpu_priority: 'idle', io_priority: 'low', max_files_per_second: 0,
+                 pause_on_battery: true, pause_load_above: ''},
+      schedules: [{id: 'a', name: 'Nightly', path: '/srv', days: [5, 1], time: '22:00',
+                   profile_name: 'fast', enabled: true}]
+    });
+
+    expect(request.throttle.max_files_per_second).toBe(null);
+    expect(request.throttle.pause_load_above).toBe(null);
+    expect(request.throttle.pause_on_battery).toBe(true);
+    expect(request.schedules[0].days).toEqual([1, 5]);
+    expect(request.schedules[0].profile.exclusions).toEqual([{type: 'glob', pattern: '*.iso'}]);
+    expect(request.update_interval).toBe(null);
+    expect(request.quarantine_path).toBe(null);
+  });
+
+  it('should send the general settings', function () {
+    var policy = angular.copy(ScanPolicy.policy);
+    policy.update_interval = '6';
+    policy.quarantine_path = '/var/quarantine';
+
+    var request = ScanPolicy.toRequest(policy);
+
+    expect(request.update_interval).toBe(6);
+    expect(request.quarantine_path).toBe('/var/quarantine');
+  });
+
+  it('should post the policy and keep it once accepted', function () {
+    var policy = angular.copy(ScanPolicy.policy);
+    policy.throttle.max_files_per_second = 200;
+
+    $httpBackend.expectPOST('/api/scan/policy', function (data) {
+      return JSON.parse(data).throttle.max_files_per_second === 200;
+    }).respond({});
+
+    ScanPolicy.save(policy);
+    $httpBackend.flush();
+
+    expect(ScanPolicy.policy.throttle.max_files_per_second).toBe(200);
+  });
+
+  it('should find the next run of a schedule', function () {
+    var schedule = {days: [1, 3], time: '22:30', enabled: true};
+    // A Wednesday, after the run of the day.
+    var next = ScanPolicy.nextRun(schedule, new Date(2016, 2, 2, 23, 0));
+
+    expect(next.getDay()).toBe(1);
+    expect(next.getHours()).toBe(22);
+    expect(next.getMinutes()).toBe(30);
+    expect(ScanPolicy.nextRun({days: [], time: '22:30', enabled: true})).toBe(null);
+    expect(ScanPolicy.nextRun({days: [1], time: '22:30', enabled: false})).toBe(null);
+  });
+});
@@ -0,0 +1,41 @@
+'use strict';
+
+describe('Service: ScanProfiles', function () {
+
+  // load the service's module
+  beforeEach(module('armaditoApp'));
+
+  // instantiate service
+  var ScanProfiles;
+  beforeEach(inject(function (_ScanProfiles_) {
+    ScanProfiles = _ScanProfiles_;
+  }));
+
+  it('should turn scan options into a scan profile', function () {
+    var profile = ScanProfiles.toRequest({
+      heuristicMode: true,
+      scanArchive: false,
+      exclusions: ['/var/lib/libvirt/images', '*/node_modules']
+    });
+
+    expect(profile.heuristic).toBe(true);
+    expect(profile.scan_archive).toBe(false);
+    expect(profile.exclusions).toEqual([
+      {type: 'prefix', pattern: '/var/lib/libvirt/images'},
+      {type: 'glob', pattern: '*/node_modules'}
+    ]);
+  });
+
+  it('should rename a profile rather than copy it', function () {
+    ScanProfiles.profiles.length = 0;
+    ScanProfiles.saveProfile('fast', {heuristicMode: false, exclusions: []});
+    ScanProfiles.saveProfile('quick', {heuristicMode: true, exclusions: []}, 'fast');
+
+    expect(ScanProfiles.profiles.length).toBe(1);
+    expect(ScanProfiles.find('fast')).toBe(null);
+    expect(ScanProfiles.find('quick').heuristicMode).toBe(true);
+
+    window.localStorage.removeItem('armadito.scan_profiles');
+  });
+
+});
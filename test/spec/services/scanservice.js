@@ -0,0 +1,151 @@
+'use strict';
+
+describe('Service: ScanService', function () {
+
+  var STORAGE_KEY = 'armadito.scan_jobs';
+
+  // load the service's module
+  beforeEach(module('armaditoApp'));
+
+  afterEach(function () {
+    window.localStorage.removeItem(STORAGE_KEY);
+  });
+
+  function saved() {
+    return JSON.parse(window.localStorage.getItem(STORAGE_KEY)) || [];
+  }
+
+  describe('with a fresh session', function () {
+    var ScanService, ApiSession, ScanHistory, $httpBackend;
+
+    beforeEach(inject(function (_ScanService_, _ApiSession_, _ScanHistory_, _$httpBackend_) {
+      ScanService = _ScanService_;
+      ScanHistory = _ScanHistory_;
+      ApiSession = _ApiSession_;
+      $httpBackend = _$httpBackend_;
+      $httpBackend.whenGET(/^scripts\/filters\/languages\//).respond({});
+      $httpBackend.whenGET('/api/register').respond({token: 'abc'});
+      spyOn(ApiSession, 'subscribe').and.returnValue(angular.noop);
+    }));
+
+    it('should save unfinished jobs until they complete', function () {
+      $httpBackend.expectPOST('/api/scan', function (data) {
+        return JSON.parse(data).checkpoint === true;
+      }).respond({});
+
+      var job = ScanService.newScan('/home', 'scan_view.Quick_scan');
+      $httpBackend.flush();
+      expect(saved()[0].id).toBe(job.id);
+
+      ScanService.handleEvent({event_type: 'OnDemandCompletedEvent', scan_id: job.id});
+      expect(saved()).toEqual([]);
+    });
+
+    it('should only record scans without detections as clean', function () {
+      $httpBackend.whenPOST('/api/scan').respond({});
+      spyOn(ScanHistory, 'recordCleanScan');
+
+      var job = ScanService.newScan('/home', 'scan_view.Quick_scan');
+      $httpBackend.flush();
+      ScanService.handleEvent({event_type: 'DetectionEvent', scan_id: job.id, path: '/home/a', scan_status: 'malware'});
+      ScanService.handleEvent({event_type: 'OnDemandCompletedEvent', scan_id: job.id});
+      expect(ScanHistory.recordCleanScan).not.toHaveBeenCalled();
+
+      job = ScanService.newScan('/home', 'scan_view.Quick_scan');
+      $httpBackend.flush();
+      ScanService.handleEvent({event_type: 'OnDemandCompletedEvent', scan_id: job.id, malware_count: 0, suspicious_count: 0});
+      expect(ScanHistory.recordCleanScan).toHaveBeenCalledWith('/home', job.started, undefined);
+    });
+
+    it('should keep interrupted jobs and resume them', function () {
+      $httpBackend.expectPOST('/api/scan').respond({});
+      var job = ScanService.newScan('/home', 'scan_view.Quick_scan');
+      $httpBackend.flush();
+
+      ScanService.handleEvent({event_type: 'OnDemandInterruptedEvent', scan_id: job.id});
+      expect(job.running).toBe(false);
+      expect(job.interrupted).toBe(true);
+      expect(saved().length).toBe(1);
+
+      $httpBackend.expectPOST('/api/scan/resume', {scan_id: job.id}).respond({});
+      ScanService.resumeScan(job);
+      $httpBackend.flush();
+      expect(job.running).toBe(true);
+    });
+  });
+
+  describe('after a restart', function () {
+    var ScanService, $httpBackend, $timeout, rootScope;
+
+    beforeEach(function () {
+      window.localStorage.setItem(STORAGE_KEY, JSON.stringify([
+        {id: 'job-1', path: '/srv', type: 'scan_view.Full_scan', options: {}, started: 1}
+      ]));
+    });
+
+    beforeEach(inject(function (_ScanService_, _ApiSession_, _$httpBackend_, _$timeout_, $rootScope) {
+      ScanService = _ScanService_;
+      $httpBackend = _$httpBackend_;
+      $timeout = _$timeout_;
+      rootScope = $rootScope;
+      $httpBackend.whenGET(/^scripts\/filters\/languages\//).respond({});
+      $httpBackend.whenGET('/api/register').respond({token: 'abc'});
+      spyOn(_ApiSession_, 'subscribe').and.returnValue(angular.noop);
+    }));
+
+    it('should reattach and replay detections before live ones', function () {
+      $httpBackend.expectPOST('/api/scan/attach', {scan_id: 'job-1'})
+        .respond({state: 'running', scanned_count: 100, malware_count: 2, progress: 40});
+      $httpBackend.expectGET(/^\/api\/scan\/detections\?.*scan_id=job-1/).respond({entries: [
+        {seq: 5, path: '/srv/a', scan_status: 'malware'},
+        {seq: 6, path: '/srv/b', scan_status: 'malware'}
+      ]});
+
+      // Startup already asked for the status.
+      var job = ScanService.jobs[0];
+      expect(job.id).toBe('job-1');
+
+      $httpBackend.flush();
+
+      expect(job.running).toBe(true);
+      expect(job.replaying).toBe(false);
+      expect(job.data.data.scanned_count).toBe(100);
+      expect(job.data.data.files.length).toBe(2);
+      expect(job.detection_seq).toBe(6);
+
+      spyOn(rootScope, '$broadcast').and.callThrough();
+      ScanService.handleEvent({event_type: 'DetectionEvent', scan_id: 'job-1', seq: 6, path: '/srv/b', scan_status: 'malware'});
+      expect(rootScope.$broadcast).not.toHaveBeenCalled();
+
+      ScanService.handleEvent({event_type: 'DetectionEvent', scan_id: 'job-1', seq: 7, path: '/srv/c', scan_status: 'malware'});
+      expect(rootScope.$broadcast).toHaveBeenCalled();
+      expect(job.detection_seq).toBe(7);
+    });
+
+    it('should forget jobs the daemon does not know anymore', function () {
+      spyOn(console, 'error');
+      $httpBackend.expectPOST('/api/scan/attach').respond(404, {});
+      $httpBackend.flush();
+
+      expect(ScanService.jobs.length).toBe(0);
+      expect(saved()).toEqual([]);
+    });
+
+    it('should keep the job and ask again when the daemon fails', function () {
+      spyOn(console, 'error');
+      $httpBackend.expectPOST('/api/scan/attach').respond(503, {});
+      $httpBackend.flush();
+
+      expect(ScanService.jobs.length).toBe(1);
+      expect(saved().length).toBe(1);
+
+      $httpBackend.expectPOST('/api/scan/attach').respond({state: 'completed', scanned_count: 10, progress: 100});
+      $httpBackend.expectGET(/^\/api\/scan\/detections\?/).respond({entries: []});
+      $timeout.flush(ScanService.attach_retry.initial);
+      $httpBackend.flush();
+
+      expect(ScanService.jobs[0].running).toBe(false);
+      expect(saved()).toEqual([]);
+    });
+  });
+});
@@ -0,0 +1,70 @@
+'use strict';
+
+describe('Service: StatusService', function () {
+
+  // load the service's module
+  beforeEach(module('armaditoApp'));
+
+  // instantiate service
+  var StatusService, $rootScope;
+  beforeEach(inject(function (_StatusService_, _$rootScope_) {
+    StatusService = _StatusService_;
+    $rootScope = _$rootScope_;
+  }));
+
+  it('should apply deltas on top of the last snapshot', function () {
+    StatusService.handleEvent({
+      event_type: 'StatusEvent',
+      global_status: 'late',
+      global_update_timestamp: 10,
+      modules: [{name: 'clamav', mod_status: 'late', mod_update_timestamp: 10},
+                {name: 'moduleH1', mod_status: 'up-to-date', mod_update_timestamp: 20}]
+    });
+    var clamav = StatusService.status.modules[0];
+
+    StatusService.handleEvent({
+      event_type: 'StatusDeltaEvent',
+      global_status: 'up-to-date',
+      global_update_timestamp: 30,
+      modules: [{name: 'clamav', mod_status: 'up-to-date', mod_update_timestamp: 30}]
+    });
+
+    expect(StatusService.status.global_status).toBe('up-to-date');
+    expect(StatusService.status.global_update_timestamp).toBe(30);
+    expect(StatusService.status.modules[0]).toBe(clamav);
+    expect(clamav.mod_status).toBe('up-to-date');
+    expect(StatusService.status.modules[1].mod_update_timestamp).toBe(20);
+  });
+
+  it('should ignore deltas received before any snapshot', function () {
+    StatusService.handleEvent({event_type: 'StatusDeltaEvent', global_status: 'late'});
+    expect(StatusService.status).toBe(null);
+  });
+
+  it('should name the modules a delta changed', function () {
+    var changed = [];
+
+    $rootScope.$on('StatusEvent', function (event, status, modules) {
+      changed.push(modules);
+    });
+
+    StatusService.handleEvent({event_type: 'StatusEvent', global_status: 'late',
+                               modules: [{name: 'clamav', mod_status: 'late'}]});
+    StatusService.handleEvent({event_type: 'StatusDeltaEvent', modules: [{name: 'clamav', mod_status: 'up-to-date'}]});
+    $rootScope.$digest();
+
+    expect(changed).toEqual([undefined, ['clamav']]);
+  });
+
+  it('should watch the status again once the channel is back', function () {
+    spyOn(StatusService, 'AskForStatus');
+
+    StatusService.handleEvent({event_type: 'ChannelStateEvent', connected: true});
+    expect(StatusService.AskForStatus).not.toHaveBeenCalled();
+
+    StatusService.handleEvent({event_type: 'ChannelStateEvent', connected: false});
+    StatusService.handleEvent({event_type: 'ChannelStateEvent', connected: true});
+    expect(StatusService.AskForStatus.calls.count()).toBe(1);
+  });
+
+});
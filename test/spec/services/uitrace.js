@@ -0,0 +1,63 @@
+'use strict';
+
+describe('Service: UiTrace', function () {
+
+  // load the service's module
+  beforeEach(module('armaditoApp'));
+
+  // instantiate service
+  var UiTrace, $httpBackend, $timeout;
+  beforeEach(inject(function (_UiTrace_, _$httpBackend_, _$timeout_) {
+    UiTrace = _UiTrace_;
+    $httpBackend = _$httpBackend_;
+    $timeout = _$timeout_;
+    $httpBackend.whenGET(/^scripts\/filters\/languages\//).respond({});
+    $httpBackend.whenGET('/api/register').respond({token: 'abc'});
+  }));
+
+  afterEach(function () {
+    UiTrace.setEnabled(false);
+    window.localStorage.removeItem('armadito.ui_trace');
+    $httpBackend.verifyNoOutstandingExpectation();
+    $httpBackend.verifyNoOutstandingRequest();
+  });
+
+  it('should record nothing while disabled', function () {
+    UiTrace.end('apply', UiTrace.begin('apply'));
+    UiTrace.count('events_received');
+
+    expect(UiTrace.snapshot().counters).toEqual({});
+    expect(UiTrace.snapshot().measures).toEqual({});
+  });
+
+  it('should keep counters and measures', function () {
+    UiTrace.setEnabled(true);
+
+    UiTrace.count('events_received', 3);
+    UiTrace.count('events_received');
+    UiTrace.end('apply', UiTrace.begin('apply'));
+    UiTrace.record('digest', 4);
+    UiTrace.record('digest', 2);
+
+    var snapshot = UiTrace.snapshot();
+
+    expect(snapshot.counters.events_received).toBe(4);
+    expect(snapshot.measures.apply.count).toBe(1);
+    expect(snapshot.measures.digest).toEqual({count: 2, avg_ms: 3, max_ms: 4});
+  });
+
+  it('should upload and reset the figures periodically', function () {
+    UiTrace.setEnabled(true);
+    UiTrace.count('events_dropped');
+
+    $httpBackend.expectPOST('/api/uimetrics', function (data) {
+      var snapshot = JSON.parse(data);
+      return snapshot.counters.events_dropped === 1 && snapshot.scan !== undefined;
+    }).respond({});
+
+    $timeout.flush(UiTrace.upload_interval);
+    $httpBackend.flush();
+
+    expect(UiTrace.snapshot().counters).toEqual({});
+  });
+});
@@ -0,0 +1,117 @@
+'use strict';
+
+describe('Service: UpdateService', function () {
+
+  // load the service's module
+  beforeEach(module('armaditoApp'));
+
+  // instantiate service
+  var UpdateService, StatusService, ApiSession, $httpBackend, $timeout;
+  beforeEach(inject(function (_UpdateService_, _StatusService_, _ApiSession_, _$httpBackend_, _$timeout_) {
+    UpdateService = _UpdateService_;
+    $timeout = _$timeout_;
+    StatusService = _StatusService_;
+    ApiSession = _ApiSession_;
+    $httpBackend = _$httpBackend_;
+    $httpBackend.whenGET(/^scripts\/filters\/languages\//).respond({});
+    $httpBackend.whenGET('/api/register').respond({token: 'abc'});
+    spyOn(ApiSession, 'subscribe').and.returnValue(angular.noop);
+  }));
+
+  afterEach(function () {
+    $httpBackend.verifyNoOutstandingExpectation();
+    $httpBackend.verifyNoOutstandingRequest();
+  });
+
+  it('should start one update at a time', function () {
+    var update;
+
+    $httpBackend.expectPOST('/api/update', function (data) {
+      data = JSON.parse(data);
+      return data.op_id === update.id && data.modules === undefined;
+    }).respond({});
+
+    update = UpdateService.start();
+    expect(UpdateService.start()).toBe(update);
+    $httpBackend.flush();
+
+    expect(ApiSession.subscribe).toHaveBeenCalled();
+  });
+
+  it('should follow the progress of each module', function () {
+    $httpBackend.expectPOST('/api/update').respond({});
+    var update = UpdateService.start(['clamav']);
+    $httpBackend.flush();
+
+    UpdateService.handleEvent({event_type: 'UpdateProgressEvent', op_id: update.id, module_name: 'clamav',
+                               state: 'downloading', mode: 'delta', downloaded_bytes: 100, total_bytes: 400});
+    UpdateService.handleEvent({event_type: 'UpdateProgressEvent', op_id: 'other', module_name: 'clamav',
+                               downloaded_bytes: 300});
+
+    expect(update.modules.clamav.mode).toBe('delta');
+    expect(update.modules.clamav.downloaded_bytes).toBe(100);
+    expect(update.total_bytes).toBe(400);
+
+    UpdateService.handleEvent({event_type: 'UpdateCompletedEvent', op_id: update.id});
+    expect(update.running).toBe(false);
+    expect(UpdateService.running()).toBe(false);
+  });
+
+  it('should update the status of the updated modules only', function () {
+    StatusService.handleEvent({
+      event_type: 'StatusEvent',
+      global_status: 'late',
+      modules: [{name: 'clamav', mod_status: 'late', mod_update_timestamp: 10},
+                {name: 'moduleH1', mod_status: 'late', mod_update_timestamp: 20}]
+    });
+
+    $httpBackend.expectPOST('/api/update').respond({});
+    var update = UpdateService.start();
+    $httpBackend.flush();
+
+    UpdateService.handleEvent({event_type: 'UpdateCompletedEvent', op_id: update.id,
+                               modules: [{name: 'clamav', mod_status: 'up-to-date', mod_update_timestamp: 30}]});
+
+    expect(StatusService.status.modules[0].mod_status).toBe('up-to-date');
+    expect(StatusService.status.modules[1].mod_status).toBe('late');
+  });
+
+  it('should mark the modules that failed', function () {
+    $httpBackend.expectPOST('/api/update').respond({});
+    var update = UpdateService.start();
+    $httpBackend.flush();
+
+    UpdateService.handleEvent({event_type: 'UpdateCompletedEvent', op_id: update.id, failed: ['moduleH1']});
+
+    expect(update.failed).toEqual(['moduleH1']);
+    expect(update.modules.moduleH1.state).toBe('failed');
+  });
+
+  it('should ask for the state of the update after lost events', function () {
+    $httpBackend.expectPOST('/api/update').respond({});
+    var update = UpdateService.start();
+    $httpBackend.flush();
+
+    $httpBackend.expectGET('/api/update?op_id=' + update.id).respond({state: 'completed', failed: ['clamav']});
+    UpdateService.handleEvent({event_type: 'EventGapEvent', first_seq: 3, last_seq: 5});
+    $httpBackend.flush();
+
+    expect(update.running).toBe(false);
+    expect(update.modules.clamav.state).toBe('failed');
+  });
+
+  it('should give up an update the daemon stopped reporting', function () {
+    spyOn(console, 'error');
+    $httpBackend.expectPOST('/api/update').respond({});
+    var update = UpdateService.start();
+    $httpBackend.flush();
+
+    $httpBackend.expectGET('/api/update?op_id=' + update.id).respond(404, {});
+    $timeout.flush(UpdateService.timeout);
+    $httpBackend.flush();
+
+    expect(update.running).toBe(false);
+    expect(UpdateService.running()).toBe(false);
+  });
+
+});